@@ -1,15 +1,41 @@
 #!/bin/bash
 
 #   Bash script to allow wm agnostic querying of running applications
-#   the format of the returned text should be of the format:
-#       monitorIdx-:-specificWindowTitle-:-windowClass-:-isFullscreen (0 or 1)-:-PID"
+#   the returned text should be one record per window, every field terminated by a NUL byte:
+#       ID\0monitorIdx\0specificWindowTitle\0windowClass\0isFullscreen (0 or 1)\0PID\0
+#   ID is any stable window id (ex. the window address), titles may contain anything but NUL
+#   (the old "monitorIdx-:-specificWindowTitle-:-windowClass-:-isFullscreen-:-PID" lines are still understood)
+#
+#   with --stream the script keeps running and prints NUL terminated messages
+#       snapshot\0, one add\0<record> per window, done\0     complete window list
+#       add\0<record>  or  remove\0ID\0                      whenever a single window changes
+#   (see src/script-stream.h), without --stream support GTKDock falls back to running it every 250ms
 
 ################
 ### Hyprland ###
 ################
 
 if [ -n "$HYPRLAND_INSTANCE_SIGNATURE" ]; then
-    hyprctl clients -j | jq -r '.[] | "\(.monitor)-:-\(.title)-:-\(.class)-:-\(.fullscreen)-:-\(.pid)"'
+    # only reached when the in-process hyprland backend can't connect to hyprland's request socket
+    # (it probes first and streams events itself), kept as an example / for hyprland versions it can't talk to
+    if [ "$1" = "--stream" ]; then
+        snapshot() {
+            printf 'snapshot\0'
+            hyprctl clients -j | jq -j '.[] | "add\u0000\(.address)\u0000\(.monitor)\u0000\(.title)\u0000\(.class)\u0000\(.fullscreen)\u0000\(.pid)\u0000"'
+            printf 'done\0'
+        }
+
+        snapshot
+        # resend the list on every window event
+        socat -U - "UNIX-CONNECT:$XDG_RUNTIME_DIR/hypr/$HYPRLAND_INSTANCE_SIGNATURE/.socket2.sock" | while read -r event; do
+            case "$event" in
+                openwindow*|closewindow*|windowtitle*|movewindow*|fullscreen*) snapshot ;;
+            esac
+        done
+        exit 0
+    fi
+
+    hyprctl clients -j | jq -j '.[] | "\(.address)\u0000\(.monitor)\u0000\(.title)\u0000\(.class)\u0000\(.fullscreen)\u0000\(.pid)\u0000"'
     exit 0
 fi
 
@@ -0,0 +1,103 @@
+#include "animation.h"
+#include <algorithm>
+#include <cmath>
+
+double applyEasing(Easing easing, double t)
+{
+    t = std::clamp(t, 0.0, 1.0);
+
+    switch (easing)
+    {
+        case Easing::EASE_IN_CUBIC:
+            return t * t * t;
+        case Easing::EASE_OUT_CUBIC:
+            return 1 - std::pow(1 - t, 3);
+        case Easing::EASE_IN_OUT_CUBIC:
+            return (t < 0.5) ? 4 * t * t * t : 1 - std::pow(-2 * t + 2, 3) / 2;
+        default:
+            return t;
+    }
+}
+
+void Tween::retarget(double target, double fullMs, double span, Easing easing)
+{
+    double distance = std::abs(target - value);
+
+    from = value;
+    to = target;
+    this->easing = easing;
+    duration = (span > 0) ? fullMs * 1000.0 * std::min(distance / span, 1.0) : 0;
+    start = -1;
+    running = distance > 0;
+}
+
+bool Tween::step(int64_t frameTime)
+{
+    if (!running) return false;
+    if (start < 0) start = frameTime;
+
+    double t = (duration > 0) ? (frameTime - start) / duration : 1;
+    value = from + (to - from) * applyEasing(easing, t);
+
+    if (t >= 1)
+    {
+        value = to;
+        running = false;
+    }
+
+    return running;
+}
+
+Animator::Animator(Gtk::Widget& widget) : widget(widget)
+{
+}
+
+void Animator::animate(Tween& tween, std::function<void()> onFrame, std::function<void()> onDone)
+{
+    auto it = std::find_if(tracks.begin(), tracks.end(), [&tween](const Track& t) { return t.tween == &tween; });
+
+    if (it != tracks.end())
+    {
+        it->onFrame = onFrame;
+        it->onDone = onDone;
+    } else
+    {
+        tracks.push_back({ &tween, onFrame, onDone });
+    }
+
+    if (tickId == 0)
+    {
+        tickId = widget.add_tick_callback([this](const Glib::RefPtr<Gdk::FrameClock>& clock) {
+            return tick(clock);
+        });
+    }
+}
+
+bool Animator::tick(const Glib::RefPtr<Gdk::FrameClock>& clock)
+{
+    int64_t now = clock->get_frame_time();
+    frames++;
+
+    // callbacks may start / retarget tracks, work on a copy
+    std::vector<Track> current = tracks;
+
+    for (Track& track : current)
+    {
+        bool more = track.tween->step(now);
+        if (track.onFrame) track.onFrame();
+
+        if (more) continue;
+
+        tracks.erase(std::remove_if(tracks.begin(), tracks.end(), [&track](const Track& t) {
+            return t.tween == track.tween && !t.tween->running;
+        }), tracks.end());
+
+        if (track.onDone && !track.tween->running) track.onDone();
+    }
+
+    if (!tracks.empty()) return true;
+
+    // returning false removes the callback
+    tickId = 0;
+    return false;
+}
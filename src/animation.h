@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <gtkmm-4.0/gtkmm.h>
+
+/*
+    animation: values that move towards a target on a widget's frame clock
+    a Tween can be retargeted at any time, it continues from wherever it currently is (no jumps when a hide gets interrupted by a show)
+    an Animator only has a tick callback registered while one of its tweens is running, an idle dock costs no frames
+*/
+
+enum class Easing
+{
+    LINEAR = 0,
+    EASE_IN_CUBIC,      // slow start, for things leaving
+    EASE_OUT_CUBIC,     // slow end, for things arriving
+    EASE_IN_OUT_CUBIC
+};
+
+double applyEasing(Easing easing, double t);
+
+// one animated value, times are frame clock times (us)
+struct Tween
+{
+    double value = 0;
+    double from = 0;
+    double to = 0;
+    double duration = 0;        // us
+    int64_t start = -1;         // -1: starts at the next frame
+    Easing easing = Easing::LINEAR;
+    bool running = false;
+
+    // moves from the current value to target, fullMs is the time for a distance of span so shorter ways take less time
+    void retarget(double target, double fullMs, double span, Easing easing);
+
+    // value at frameTime, false once the target is reached
+    bool step(int64_t frameTime);
+};
+
+class Animator
+{
+    public:
+        explicit Animator(Gtk::Widget& widget);
+
+        // runs tween (already retargeted) until it is done, onFrame after every step, onDone once it arrived
+        // a tween that is already running just gets the new callbacks
+        void animate(Tween& tween, std::function<void()> onFrame, std::function<void()> onDone = {});
+
+        uint64_t frames = 0;
+
+    private:
+        struct Track
+        {
+            Tween * tween = nullptr;
+            std::function<void()> onFrame;
+            std::function<void()> onDone;
+        };
+
+        Gtk::Widget& widget;
+        std::vector<Track> tracks = {};
+        guint tickId = 0;
+
+        bool tick(const Glib::RefPtr<Gdk::FrameClock>& clock);
+};
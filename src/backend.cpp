@@ -0,0 +1,212 @@
+#include "backend.h"
+#include "hyprland-ipc.h"
+#include "sway-ipc.h"
+#include "foreign-toplevel.h"
+#include "x11-ewmh.h"
+#include "poll-scheduler.h"
+#include <dlfcn.h>
+
+static const gtkdock_backend * selected = nullptr;
+static InstancesCallback changeCallback;
+
+static gtkdock_instance toBackendInstance(const AppInstance& i)
+{
+    return { i.monitorIdx, i.title.c_str(), i.wclass.c_str(), i.fullscreen, i.pid, i.id.c_str() };
+}
+
+static std::vector<AppInstance> toAppInstances(const gtkdock_instance * instances, size_t count)
+{
+    std::vector<AppInstance> res = {};
+    res.reserve(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const gtkdock_instance& c = instances[i];
+        res.push_back({ c.monitor_idx, c.title ? c.title : "-", c.wclass ? c.wclass : "-", c.fullscreen != 0, c.pid, c.id ? c.id : "" });
+    }
+
+    return res;
+}
+
+static void collectInstances(const gtkdock_instance * instances, size_t count, void * user_data)
+{
+    *static_cast<std::vector<AppInstance> *>(user_data) = toAppInstances(instances, count);
+}
+
+static void forwardInstances(const gtkdock_instance * instances, size_t count, void *)
+{
+    if (changeCallback) changeCallback(toAppInstances(instances, count));
+}
+
+void emitInstances(const std::vector<AppInstance>& instances, gtkdock_instances_cb cb, void * user_data)
+{
+    std::vector<gtkdock_instance> converted = {};
+    converted.reserve(instances.size());
+
+    for (const AppInstance& i : instances)
+        converted.push_back(toBackendInstance(i));
+
+    cb(converted.data(), converted.size(), user_data);
+}
+
+void runWatcherThread(std::atomic<bool>& running, const std::function<void(std::atomic<bool>&, const InstancesCallback&)>& watch,
+    const std::function<std::vector<AppInstance>()>& enumerate, gtkdock_instances_cb cb, void * user_data)
+{
+    running = true;
+
+    std::thread([&running, watch, enumerate, cb, user_data]() {
+        watch(running, [cb, user_data](const std::vector<AppInstance>& instances) {
+            emitInstances(instances, cb, user_data);
+        });
+
+        // socket / connection went away, keep the dock alive by polling
+        std::vector<AppInstance> last = {};
+        bool first = true;
+
+        while (running)
+        {
+            std::vector<AppInstance> instances = enumerate();
+            bool changed = first || !identicalInstances(instances, last);
+
+            if (changed) emitInstances(instances, cb, user_data);
+
+            last = std::move(instances);
+            first = false;
+            pollSchedulerWait(changed);
+        }
+    }).detach();
+}
+
+// dlopens every *.so in the backend dirs, incompatible ones get unloaded again
+static std::vector<std::pair<void *, const gtkdock_backend *>> loadSharedBackends()
+{
+    std::vector<std::pair<void *, const gtkdock_backend *>> backends = {};
+    std::vector<std::filesystem::path> dirs = { Glib::get_home_dir() + "/.config/GTKDock/backends", "./backends" };
+
+    for (const auto& dir : dirs)
+    {
+        if (!std::filesystem::is_directory(dir)) continue;
+
+        std::vector<std::filesystem::path> files = {};
+        for (const auto& entry : std::filesystem::directory_iterator(dir))
+        {
+            if (entry.path().extension() == ".so") files.push_back(entry.path());
+        }
+
+        // load order shouldn't depend on directory order
+        std::sort(files.begin(), files.end());
+
+        for (const auto& file : files)
+        {
+            void * handle = dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL);
+            if (handle == NULL)
+            {
+                std::cerr << "Couldn't load backend " << file << ": " << dlerror() << std::endl;
+                continue;
+            }
+
+            auto entry = reinterpret_cast<gtkdock_backend_entry_fn>(dlsym(handle, GTKDOCK_BACKEND_ENTRY_SYMBOL));
+            const gtkdock_backend * b = (entry != NULL) ? entry() : nullptr;
+
+            if (b == nullptr || b->abi_version != GTKDOCK_BACKEND_ABI_VERSION || b->probe == NULL || b->enumerate == NULL)
+            {
+                std::cerr << "Ignoring backend " << file << ": missing " << GTKDOCK_BACKEND_ENTRY_SYMBOL << " or incompatible abi version" << std::endl;
+                dlclose(handle);
+                continue;
+            }
+
+            backends.push_back({ handle, b });
+        }
+    }
+
+    return backends;
+}
+
+bool startBackend(const InstancesCallback& onChange)
+{
+    auto shared = loadSharedBackends();
+
+    std::vector<const gtkdock_backend *> candidates = {};
+    for (auto& pair : shared)
+        candidates.push_back(pair.second);
+
+    candidates.insert(candidates.end(), { hyprlandBackend(), swayBackend(), foreignToplevelBackend(), x11Backend() });
+
+    for (const gtkdock_backend * b : candidates)
+    {
+        if (!b->probe()) continue;
+
+        selected = b;
+        std::cout << "Using window backend: " << b->name << std::endl;
+        break;
+    }
+
+    for (auto& pair : shared)
+    {
+        if (pair.second != selected) dlclose(pair.first);
+    }
+
+    if (selected == nullptr) return false;
+
+    changeCallback = onChange;
+
+    // dock gets built right after this, give it the current windows before any event arrived
+    onChange(backendEnumerate());
+
+    return selected->subscribe != NULL && selected->subscribe(forwardInstances, nullptr) == 0;
+}
+
+const gtkdock_backend * activeBackend()
+{
+    return selected;
+}
+
+std::vector<AppInstance> backendEnumerate()
+{
+    std::vector<AppInstance> res = {};
+    if (selected != nullptr) selected->enumerate(collectInstances, &res);
+    return res;
+}
+
+void backendActivate(const AppInstance& inst)
+{
+    if (selected != nullptr && selected->activate != NULL && !inst.id.empty())
+        selected->activate(inst.id.c_str());
+}
+
+void backendClose(const std::vector<AppInstance>& instances)
+{
+    if (selected == nullptr || selected->close == NULL) return;
+
+    std::vector<const char *> ids = {};
+    for (const AppInstance& i : instances)
+    {
+        if (!i.id.empty()) ids.push_back(i.id.c_str());
+    }
+
+    if (!ids.empty()) selected->close(ids.data(), ids.size());
+}
+
+std::vector<std::pair<std::string, std::string>> backendMenuActions(const AppInstance& inst)
+{
+    std::vector<std::pair<std::string, std::string>> res = {};
+    if (selected == nullptr || selected->menu_actions == NULL || inst.id.empty()) return res;
+
+    gtkdock_instance c = toBackendInstance(inst);
+    gtkdock_menu_action actions[8] = {};
+    size_t n = std::min(selected->menu_actions(&c, actions, 8), (size_t)8);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (actions[i].label != NULL && actions[i].action != NULL)
+            res.push_back({ actions[i].label, actions[i].action });
+    }
+
+    return res;
+}
+
+void backendRunMenuAction(const AppInstance& inst, const std::string& action)
+{
+    if (selected != nullptr && selected->run_menu_action != NULL && !inst.id.empty())
+        selected->run_menu_action(inst.id.c_str(), action.c_str());
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include "utils.h"
+#include "dock-backend.h"
+
+/*
+    backend.h: loads and drives gtkdock_backend implementations (see dock-backend.h)
+    shared objects from ~/.config/GTKDock/backends and ./backends are tried first, then the built in
+    hyprland, sway, wlr-foreign-toplevel and X11 backends; without any of them list_windows.bash gets polled
+*/
+
+typedef std::function<void(const std::vector<AppInstance>&)> InstancesCallback;
+
+// converts instances into gtkdock_instances and hands them to cb (for the built in backends)
+void emitInstances(const std::vector<AppInstance>& instances, gtkdock_instances_cb cb, void * user_data);
+
+// runs a blocking watcher on a detached thread, polls enumerate instead if the watcher gives up early
+void runWatcherThread(std::atomic<bool>& running, const std::function<void(std::atomic<bool>&, const InstancesCallback&)>& watch,
+    const std::function<std::vector<AppInstance>()>& enumerate, gtkdock_instances_cb cb, void * user_data);
+
+// picks the backend for this session and subscribes onChange to it
+// returns true if the backend pushes changes, false if instances have to be polled
+// has to run after gtk is initialized (foreign toplevel and X11 share gdk's display)
+bool startBackend(const InstancesCallback& onChange);
+
+// selected backend or nullptr if list_windows.bash is used
+const gtkdock_backend * activeBackend();
+
+std::vector<AppInstance> backendEnumerate();
+void backendActivate(const AppInstance& inst);
+void backendClose(const std::vector<AppInstance>& instances);
+
+// extra popover entries as (label, action)
+std::vector<std::pair<std::string, std::string>> backendMenuActions(const AppInstance& inst);
+void backendRunMenuAction(const AppInstance& inst, const std::string& action);
@@ -0,0 +1,309 @@
+#include "desktop-index.h"
+#include <set>
+#include <cmath>
+
+// exact match scores per field
+static const int SCORE_WMCLASS = 100;
+static const int SCORE_FLATPAK = 95;
+static const int SCORE_ID = 90;
+static const int SCORE_ID_SUFFIX = 80;
+static const int SCORE_EXEC = 70;
+static const int SCORE_NAME = 60;
+
+// token weights per field, class tokens count CLASS_TOKEN_FACTOR times
+static const int WEIGHT_WMCLASS = 4;
+static const int WEIGHT_ID = 3;
+static const int WEIGHT_EXEC = 3;
+static const int WEIGHT_NAME = 2;
+static const int CLASS_TOKEN_FACTOR = 3;
+// tokens get scaled by how rare they are (idf), "org" / "gnome" / "com" alone shouldn't decide anything
+static const double MIN_TOKEN_SCORE = 6.0;
+
+static const size_t MIN_TOKEN_LENGTH = 3;
+static const double MIN_TRIGRAM_SIMILARITY = 0.6;
+
+// shells in Exec lines say nothing about which app runs
+static const std::set<std::string> genericExecs = { "sh", "bash", "env", "flatpak" };
+
+std::string desktopFileId(const std::string& desktopFile)
+{
+    std::string id = std::filesystem::path(desktopFile).filename().string();
+    if (id.size() > 8 && id.compare(id.size() - 8, 8, ".desktop") == 0) id.erase(id.size() - 8);
+    return id;
+}
+
+// "org.gnome.Nautilus" --> "Nautilus"
+static std::string idSuffix(const std::string& id)
+{
+    size_t dot = id.rfind('.');
+    return (dot == std::string::npos) ? "" : id.substr(dot + 1);
+}
+
+// "env FOO=1 /usr/bin/firefox --new-window" --> "/usr/bin/firefox", flatpak launchers also fill in the app id
+static std::string execBinary(const std::string& execCmd, std::string& flatpakId)
+{
+    std::vector<std::string> words = splitStr(execCmd, " ");
+    size_t i = 0;
+
+    if (i < words.size() && std::filesystem::path(words[i]).filename() == "env")
+    {
+        i++;
+        while (i < words.size() && words[i].find('=') != std::string::npos) i++;
+    }
+
+    if (i >= words.size()) return "";
+
+    std::string bin = words[i];
+
+    if (std::filesystem::path(bin).filename() == "flatpak" && flatpakId.empty())
+    {
+        // flatpak run [--options] org.foo.Bar [args]
+        for (size_t j = i + 1; j < words.size(); j++)
+        {
+            if (words[j] != "run" && words[j][0] != '-')
+            {
+                flatpakId = words[j];
+                break;
+            }
+        }
+    }
+
+    return bin;
+}
+
+// "LibreOffice Writer" / "libreoffice-writer" --> {"libreoffice", "writer"}
+static std::vector<std::string> tokenize(const std::string& s)
+{
+    std::vector<std::string> res = {};
+    std::string cur = "";
+
+    for (char c : s)
+    {
+        if (isalnum((unsigned char)c))
+        {
+            cur += tolower((unsigned char)c);
+        } else if (!cur.empty())
+        {
+            res.push_back(cur);
+            cur = "";
+        }
+    }
+
+    if (!cur.empty()) res.push_back(cur);
+    return res;
+}
+
+static std::set<std::string> trigramsOf(const std::string& normalized)
+{
+    std::set<std::string> res = {};
+
+    for (size_t i = 0; i + 3 <= normalized.size(); i++)
+        res.insert(normalized.substr(i, 3));
+
+    return res;
+}
+
+void DesktopIndex::build(const std::vector<DesktopEntry>& desktopFiles)
+{
+    entries = desktopFiles;
+    exact.clear();
+    tokens.clear();
+    trigrams.clear();
+    trigramCounts.assign(entries.size(), 0);
+    byFile.clear();
+    byId.clear();
+    execs.clear();
+
+    for (int i = 0; i < (int)entries.size(); i++)
+    {
+        const DesktopEntry& dE = entries[i];
+        std::string id = desktopFileId(dE.desktopFile);
+        std::string flatpakId = dE.flatpakId;
+        std::string execBin = execBinary(dE.execCmd, flatpakId);
+        std::string exec = std::filesystem::path(execBin).filename().string();
+
+        byFile.emplace(dE.desktopFile, i);
+        byId.emplace(id, i);
+        if (!flatpakId.empty()) byId.emplace(flatpakId, i);
+
+        if (!exec.empty() && genericExecs.count(exec) == 0)
+        {
+            execs[exec].push_back(i);
+            if (execBin != exec) execs[execBin].push_back(i);
+        }
+
+        auto addExact = [this, i](const std::string& value, int score) {
+            std::string key = normalizeString(value);
+            if (!key.empty()) exact[key].push_back({ i, score });
+        };
+
+        auto addTokens = [this, i](const std::string& value, int weight) {
+            for (const std::string& t : tokenize(value))
+            {
+                if (t.size() >= MIN_TOKEN_LENGTH) tokens[t].push_back({ i, weight });
+            }
+        };
+
+        addExact(dE.startupWMClass, SCORE_WMCLASS);
+        addExact(flatpakId, SCORE_FLATPAK);
+        addExact(id, SCORE_ID);
+        addExact(idSuffix(id), SCORE_ID_SUFFIX);
+        addExact(exec, SCORE_EXEC);
+        addExact(dE.name, SCORE_NAME);
+
+        addTokens(dE.startupWMClass, WEIGHT_WMCLASS);
+        addTokens(id, WEIGHT_ID);
+        addTokens(exec, WEIGHT_EXEC);
+        addTokens(dE.name, WEIGHT_NAME);
+
+        std::set<std::string> grams = trigramsOf(normalizeString(id));
+        for (const std::string& g : trigramsOf(normalizeString(dE.name)))
+            grams.insert(g);
+
+        for (const std::string& g : grams)
+            trigrams[g].push_back(i);
+
+        trigramCounts[i] = grams.size();
+    }
+}
+
+int DesktopIndex::find(const std::string& desktopFile) const
+{
+    auto it = byFile.find(desktopFile);
+    return (it == byFile.end()) ? -1 : it->second;
+}
+
+int DesktopIndex::findId(const std::string& id) const
+{
+    auto it = byId.find(id);
+    return (it == byId.end()) ? -1 : it->second;
+}
+
+int DesktopIndex::findExec(const std::string& path) const
+{
+    auto it = execs.find(path);
+    if (it == execs.end())
+        it = execs.find(std::filesystem::path(path).filename().string());
+
+    // several entries start the same binary (libreoffice --writer / --calc ...), can't tell them apart
+    if (it == execs.end() || it->second.size() != 1) return -1;
+    return it->second[0];
+}
+
+// highest scoring field that equals key
+int DesktopIndex::matchExact(const std::string& key) const
+{
+    auto it = exact.find(normalizeString(key));
+    if (it == exact.end()) return -1;
+
+    int best = -1;
+    int bestScore = 0;
+
+    for (const auto& [entry, score] : it->second)
+    {
+        if (score > bestScore || (score == bestScore && entry < best))
+        {
+            best = entry;
+            bestScore = score;
+        }
+    }
+
+    return best;
+}
+
+int DesktopIndex::matchTokens(const std::string& wclass, const std::string& title) const
+{
+    std::unordered_map<int, double> scores = {};
+
+    auto score = [this, &scores](const std::string& s, int factor) {
+        std::set<std::string> seen = {};
+
+        for (const std::string& t : tokenize(s))
+        {
+            if (t.size() < MIN_TOKEN_LENGTH || !seen.insert(t).second) continue;
+
+            auto it = tokens.find(t);
+            if (it == tokens.end()) continue;
+
+            // every field counts once per query token
+            std::unordered_map<int, int> best = {};
+            for (const auto& [entry, weight] : it->second)
+                best[entry] = std::max(best[entry], weight);
+
+            double idf = std::log(1.0 + (double)entries.size() / best.size());
+
+            for (const auto& [entry, weight] : best)
+                scores[entry] += weight * factor * idf;
+        }
+    };
+
+    score(wclass, CLASS_TOKEN_FACTOR);
+    if (title != "-") score(title, 1);
+
+    int best = -1;
+    double bestScore = 0;
+    bool tie = false;
+
+    for (const auto& [entry, s] : scores)
+    {
+        if (s > bestScore)
+        {
+            best = entry;
+            bestScore = s;
+            tie = false;
+        } else if (s == bestScore)
+        {
+            tie = true;
+        }
+    }
+
+    // two entries sharing the same tokens, let the trigrams decide
+    if (tie || bestScore < MIN_TOKEN_SCORE) return -1;
+    return best;
+}
+
+int DesktopIndex::matchTrigrams(const std::string& wclass) const
+{
+    std::set<std::string> query = trigramsOf(normalizeString(wclass));
+    if (query.empty()) return -1;
+
+    std::unordered_map<int, int> common = {};
+    for (const std::string& g : query)
+    {
+        auto it = trigrams.find(g);
+        if (it == trigrams.end()) continue;
+
+        for (int entry : it->second)
+            common[entry]++;
+    }
+
+    int best = -1;
+    double bestSimilarity = MIN_TRIGRAM_SIMILARITY;
+
+    for (const auto& [entry, n] : common)
+    {
+        // dice coefficient
+        double similarity = 2.0 * n / (query.size() + trigramCounts[entry]);
+
+        if (similarity > bestSimilarity || (similarity == bestSimilarity && entry < best))
+        {
+            best = entry;
+            bestSimilarity = similarity;
+        }
+    }
+
+    return best;
+}
+
+int DesktopIndex::match(const std::string& wclass, const std::string& title) const
+{
+    int hit = -1;
+
+    // class matches always rank above title matches
+    if (wclass != "-" && (hit = matchExact(wclass)) >= 0) return hit;
+    if (title != "-" && (hit = matchExact(title)) >= 0) return hit;
+    if ((hit = matchTokens(wclass, title)) >= 0) return hit;
+    if (wclass != "-") return matchTrigrams(wclass);
+
+    return -1;
+}
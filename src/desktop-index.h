@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "utils.h"
+
+/*
+    DesktopIndex: in-memory index over the desktop files used to find the entry of a window
+    indexed: desktop file id (also its last reverse-dns part), Name, StartupWMClass, Exec basename, flatpak app id,
+    their tokens and the trigrams of id / name
+
+    match() ranks candidates instead of taking the first substring hit:
+        1. normalized class equals one of the fields (StartupWMClass > flatpak id > id > exec > name)
+        2. class / title tokens hitting field tokens weighted by rarity (class tokens weigh more, tokens shorter than 3 chars are ignored)
+        3. trigram similarity of the class to id / name
+    exact / trigram ties go to the earlier desktop file so results don't depend on hash order,
+    a token tie between two entries counts as no token match and is left to the trigrams
+*/
+
+struct DesktopIndex
+{
+    std::vector<DesktopEntry> entries = {};
+
+    void build(const std::vector<DesktopEntry>& desktopFiles);
+
+    // index into entries or -1 if nothing matches well enough
+    int match(const std::string& wclass, const std::string& title) const;
+
+    // index of the entry with this desktop file path or -1
+    int find(const std::string& desktopFile) const;
+
+    // index of the entry with this desktop file id / flatpak app id or -1
+    int findId(const std::string& id) const;
+
+    // index of the only entry launching this binary (full path or basename) or -1 if none / several do
+    int findExec(const std::string& path) const;
+
+    private:
+        // normalized key -> (entry, score)
+        std::unordered_map<std::string, std::vector<std::pair<int, int>>> exact = {};
+        // token -> (entry, weight)
+        std::unordered_map<std::string, std::vector<std::pair<int, int>>> tokens = {};
+        // trigram -> entries
+        std::unordered_map<std::string, std::vector<int>> trigrams = {};
+        std::vector<int> trigramCounts = {};
+        std::unordered_map<std::string, int> byFile = {};
+        std::unordered_map<std::string, int> byId = {};
+        // Exec binary (as written and its basename) -> entries
+        std::unordered_map<std::string, std::vector<int>> execs = {};
+
+        int matchExact(const std::string& key) const;
+        int matchTokens(const std::string& wclass, const std::string& title) const;
+        int matchTrigrams(const std::string& wclass) const;
+};
+
+// desktop file id ex. "/usr/share/applications/org.gnome.Nautilus.desktop" --> "org.gnome.Nautilus"
+std::string desktopFileId(const std::string& desktopFile);
@@ -0,0 +1,76 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+    GTKDock window backend ABI
+
+    a backend is a shared object exporting
+        const gtkdock_backend * gtkdock_backend_entry(void);
+    GTKDock loads every *.so in ~/.config/GTKDock/backends and ./backends at startup, then the built in backends,
+    and uses the first one whose probe() returns nonzero
+
+    rules:
+        abi_version has to be exactly GTKDOCK_BACKEND_ABI_VERSION, backends built for another version get ignored
+        any change to the structs below (including appended fields, gtkdock_instance is handed over as an array) bumps it,
+        so every version bump breaks existing backends until they are rebuilt against the new header
+        any function pointer except probe and enumerate may be NULL
+        strings handed to callbacks are only valid during the call
+        activate / close / menu actions are called from the gtk main thread
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GTKDOCK_BACKEND_ABI_VERSION 1
+#define GTKDOCK_BACKEND_ENTRY_SYMBOL "gtkdock_backend_entry"
+
+typedef struct gtkdock_instance
+{
+    int monitor_idx;
+    const char * title;
+    const char * wclass;
+    int fullscreen;
+    int pid;
+    const char * id;        // backend specific window id, handed back to activate / close / run_menu_action
+} gtkdock_instance;
+
+typedef struct gtkdock_menu_action
+{
+    const char * label;     // button text in the instance popover
+    const char * action;    // passed to run_menu_action
+} gtkdock_menu_action;
+
+// receives a full snapshot of all windows
+typedef void (*gtkdock_instances_cb)(const gtkdock_instance * instances, size_t count, void * user_data);
+
+typedef struct gtkdock_backend
+{
+    uint32_t abi_version;
+    const char * name;
+
+    // nonzero if the backend can run in this session (env vars, sockets, protocols ...)
+    int (*probe)(void);
+
+    // calls cb once with the current windows
+    void (*enumerate)(gtkdock_instances_cb cb, void * user_data);
+
+    // starts pushing snapshots to cb whenever windows change, cb may be called from any thread
+    // returns 0 on success, nonzero makes GTKDock poll enumerate instead
+    int (*subscribe)(gtkdock_instances_cb cb, void * user_data);
+    void (*unsubscribe)(void);
+
+    void (*activate)(const char * id);
+    void (*close)(const char * const * ids, size_t count);
+
+    // extra popover entries for one window, fills at most max actions and returns how many were filled
+    size_t (*menu_actions)(const gtkdock_instance * instance, gtkdock_menu_action * actions, size_t max);
+    void (*run_menu_action)(const char * id, const char * action);
+} gtkdock_backend;
+
+typedef const gtkdock_backend * (*gtkdock_backend_entry_fn)(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,498 @@
+#include "dock-view.h"
+#include "texture-cache.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+static const double MAGNIFY_FADE_MS = 150;
+
+DockView::DockView() : Glib::ObjectBase("DockView")
+{
+    set_has_tooltip(true);
+
+    // only drawn, clicks on the bar are clicks on the view
+    bar.add_css_class("bar");
+    bar.set_can_target(false);
+    bar.set_parent(*this);
+
+    // icons that were still decoding replace their placeholders
+    textureReady = textureCacheReady().connect([this]() { queue_draw(); });
+
+    // textures are held at the old device pixel size, get them decoded for the new scale
+    property_scale_factor().signal_changed().connect([this]() {
+        textures.clear();
+        textureCacheTrim();
+        queue_draw();
+    });
+
+    // only events aimed at the view itself, not the ones bubbling up from the menus parented to it
+    auto click = Gtk::GestureClick::create();
+    click->set_button(0);
+    click->set_propagation_phase(Gtk::PropagationPhase::TARGET);
+
+    click->signal_released().connect([this, click](int n_press, double x, double y) {
+        int i = itemAt(x, y);
+        if (i >= 0 && !items[i].separator && onActivate) onActivate(items[i].key, click->get_current_button());
+    });
+
+    add_controller(click);
+
+    auto motion = Gtk::EventControllerMotion::create();
+    motion->set_propagation_phase(Gtk::PropagationPhase::TARGET);
+
+    motion->signal_enter().connect([this](double x, double y) {
+        pointerMoved(x, y);
+
+        if (magnifyScale <= 1) return;
+        magnify.retarget(1, MAGNIFY_FADE_MS, 1, Easing::EASE_OUT_CUBIC);
+        animator.animate(magnify, [this]() { queue_draw(); });
+    });
+
+    motion->signal_motion().connect([this](double x, double y) {
+        pointerMoved(x, y);
+    });
+
+    motion->signal_leave().connect([this]() {
+        setHovered(-1);
+
+        if (magnifyScale <= 1) return;
+        magnify.retarget(0, MAGNIFY_FADE_MS, 1, Easing::EASE_OUT_CUBIC);
+        animator.animate(magnify, [this]() { queue_draw(); });
+    });
+
+    add_controller(motion);
+
+    auto scroll = Gtk::EventControllerScroll::create();
+    scroll->set_flags(Gtk::EventControllerScroll::Flags::BOTH_AXES | Gtk::EventControllerScroll::Flags::DISCRETE);
+    scroll->set_propagation_phase(Gtk::PropagationPhase::TARGET);
+
+    scroll->signal_scroll().connect([this](double dx, double dy) {
+        double d = (dy != 0) ? dy : dx;
+        if (d == 0) return false;
+
+        // let the scroll through if there was nothing to scroll
+        return scrollBy((d > 0) ? 1 : -1);
+    }, false);
+
+    add_controller(scroll);
+
+    signal_query_tooltip().connect([this](int x, int y, bool keyboard, const Glib::RefPtr<Gtk::Tooltip>& tooltip) {
+        int i = itemAt(x, y);
+        if (i < 0 || items[i].separator) return false;
+
+        tooltip->set_text(items[i].name);
+        tooltip->set_tip_area(itemRect(items[i].key));
+        return true;
+    }, false);
+}
+
+DockView::~DockView()
+{
+    textureReady.disconnect();
+    clearDotNodes();
+
+    // the bar and menus that are still around
+    while (Gtk::Widget * child = get_first_child())
+        child->unparent();
+}
+
+void DockView::configure(bool vertical, int iconSize, int bgSize, int padding)
+{
+    this->vertical = vertical;
+    this->iconSize = iconSize;
+    this->bgSize = bgSize;
+    this->padding = padding;
+
+    clearDotNodes();
+    textures.clear();
+    textureCacheTrim();
+    layout();
+}
+
+void DockView::setItems(const std::vector<Item>& items)
+{
+    this->items = items;
+    hovered = -1;
+
+    // textures of icons that aren't shown anymore
+    std::set<std::string> paths = {};
+    for (const Item& item : items)
+        paths.insert(item.iconPath);
+
+    for (auto it = textures.begin(); it != textures.end();)
+    {
+        if (paths.count(it->first) == 0) it = textures.erase(it);
+        else it++;
+    }
+
+    textureCacheTrim();
+
+    layout();
+}
+
+void DockView::setVisibleLength(int length)
+{
+    if (visibleLength == length) return;
+
+    visibleLength = length;
+    layout();
+}
+
+bool DockView::scrollBy(int steps)
+{
+    int prev = scrollFirst;
+    scrollFirst += steps;
+    layout();
+
+    return scrollFirst != prev;
+}
+
+double DockView::extent(const Item& item) const
+{
+    return item.separator ? 6 : bgSize + padding;
+}
+
+void DockView::layout()
+{
+    layouts++;
+    int n = items.size();
+
+    // where every item would be on an endless dock
+    std::vector<double> offsets = {};
+    double length = 0;
+
+    for (const Item& item : items)
+    {
+        offsets.push_back(length);
+        length += extent(item);
+    }
+
+    // don't scroll past the point where the last item sits at the end of the dock
+    int maxFirst = 0;
+    while (maxFirst < n && length - offsets[maxFirst] > visibleLength + 0.5) maxFirst++;
+    scrollFirst = std::clamp(scrollFirst, 0, maxFirst);
+
+    double scrollOffset = (n > 0) ? offsets[scrollFirst] : 0;
+    int last = scrollFirst;
+    slots.clear();
+
+    while (last < n && offsets[last] - scrollOffset + extent(items[last]) - (items[last].separator ? 0 : padding) <= visibleLength + 0.5)
+    {
+        double pos = offsets[last] - scrollOffset;
+
+        if (vertical) slots.push_back({ (size_t)last, 0, pos });
+        else slots.push_back({ (size_t)last, pos, 0 });
+
+        last++;
+    }
+
+    if (scrollFirst > 0) bar.add_css_class("overflow-start");
+    else bar.remove_css_class("overflow-start");
+
+    if (last < n) bar.add_css_class("overflow-end");
+    else bar.remove_css_class("overflow-end");
+
+    queue_resize();
+}
+
+void DockView::setSlide(double dx, double dy)
+{
+    if (slideX == dx && slideY == dy) return;
+
+    slideX = dx;
+    slideY = dy;
+    queue_draw();
+}
+
+void DockView::setBar(const Gdk::Rectangle& rect)
+{
+    if (barRect.equals(rect)) return;
+
+    barRect = rect;
+    queue_allocate();
+}
+
+int DockView::itemAt(double x, double y) const
+{
+    // items are where they are drawn, a slid out dock has none under the pointer
+    x -= slideX;
+    y -= slideY;
+
+    for (const Slot& slot : slots)
+    {
+        double w = bgSize;
+        double h = bgSize;
+
+        if (items[slot.item].separator)
+        {
+            if (vertical) h = 6;
+            else w = 6;
+        }
+
+        if (x >= slot.x && x < slot.x + w && y >= slot.y && y < slot.y + h) return slot.item;
+    }
+
+    return -1;
+}
+
+Gdk::Rectangle DockView::itemRect(const std::string& key) const
+{
+    for (const Slot& slot : slots)
+    {
+        if (items[slot.item].key == key) return Gdk::Rectangle(slot.x, slot.y, bgSize, bgSize);
+    }
+
+    return Gdk::Rectangle(0, 0, 0, 0);
+}
+
+void DockView::setMagnification(double maxScale, Gtk::PositionType edge)
+{
+    magnifyScale = maxScale;
+    magnifyEdge = edge;
+
+    // decoded at the new size
+    textures.clear();
+    textureCacheTrim();
+    queue_draw();
+}
+
+void DockView::pointerMoved(double x, double y)
+{
+    setHovered(itemAt(x, y));
+
+    if (magnifyScale <= 1) return;
+
+    pointer = vertical ? y : x;
+    queue_draw();
+}
+
+// 1 far from the pointer, magnifyScale right under it
+double DockView::itemScale(const Slot& slot) const
+{
+    if (magnifyScale <= 1 || magnify.value <= 0) return 1;
+
+    double center = (vertical ? slot.y : slot.x) + bgSize / 2.0;
+    double d = (pointer - center) / (MAGNIFY_RANGE * bgSize);
+    if (std::abs(d) >= 1) return 1;
+
+    return 1 + (magnifyScale - 1) * (1 - d * d) * magnify.value;
+}
+
+void DockView::setHovered(int idx)
+{
+    if (hovered == idx) return;
+
+    hovered = idx;
+    queue_draw();
+}
+
+void DockView::measure_vfunc(Gtk::Orientation orientation, int for_size, int& minimum, int& natural, int& minimum_baseline, int& natural_baseline) const
+{
+    bool along = (orientation == Gtk::Orientation::HORIZONTAL) != vertical;
+
+    minimum = natural = along ? visibleLength : bgSize;
+    minimum_baseline = natural_baseline = -1;
+}
+
+void DockView::size_allocate_vfunc(int width, int height, int baseline)
+{
+    int min = 0, nat = 0, minBaseline = 0, natBaseline = 0;
+    bar.measure(Gtk::Orientation::HORIZONTAL, -1, min, nat, minBaseline, natBaseline);
+    bar.size_allocate(barRect, -1);
+
+    // popovers have to be presented by the widget they are parented to
+    for (Gtk::Widget * child = get_first_child(); child != nullptr; child = child->get_next_sibling())
+    {
+        if (auto popover = dynamic_cast<Gtk::Popover *>(child)) popover->present();
+    }
+}
+
+// icon at iconSize (magnified) device pixels from the shared texture cache, held as long as it is shown
+// nullptr while it is decoding (pending) or if it can't be read
+Glib::RefPtr<Gdk::Texture> DockView::texture(const std::string& path, bool& pending)
+{
+    pending = false;
+    if (path.empty()) return {};
+
+    auto it = textures.find(path);
+    if (it != textures.end()) return it->second;
+
+    bool ready = false;
+    Glib::RefPtr<Gdk::Texture> tex = textureCacheGet(path, std::ceil(iconSize * std::max(magnifyScale, 1.0)), get_scale_factor(), ready);
+
+    pending = !ready;
+    if (ready) textures[path] = tex;
+    return tex;
+}
+
+void DockView::clearDotNodes()
+{
+    for (GskRenderNode * node : dotNodes)
+    {
+        if (node != nullptr) gsk_render_node_unref(node);
+    }
+
+    dotNodes.clear();
+}
+
+static void appendCircle(GtkSnapshot * s, double cx, double cy, double r, const GdkRGBA& color)
+{
+    graphene_rect_t rect;
+    graphene_rect_init(&rect, cx - r, cy - r, 2 * r, 2 * r);
+
+    GskRoundedRect clip;
+    gsk_rounded_rect_init_from_rect(&clip, &rect, r);
+
+    gtk_snapshot_push_rounded_clip(s, &clip);
+    gtk_snapshot_append_color(s, &color, &rect);
+    gtk_snapshot_pop(s);
+}
+
+/*
+    window count indicator below the icon, bgSize wide
+    1 - 3 windows: as many dots, 4 or more: 4 dots
+*/
+GskRenderNode * DockView::dotsNode(int count, const GdkRGBA& color)
+{
+    if (!gdk_rgba_equal(&color, &dotColor))
+    {
+        clearDotNodes();
+        dotColor = color;
+    }
+
+    count = std::min(count, 4);
+    if (dotNodes.size() < 5) dotNodes.resize(5, nullptr);
+    if (dotNodes[count] != nullptr) return dotNodes[count];
+
+    double w = bgSize;
+    double h = iconSize / 8.f - 2;
+    double r = h / 2.0;
+
+    GtkSnapshot * s = gtk_snapshot_new();
+
+    if (count == 1)
+    {
+        appendCircle(s, w / 2.0, r, r, color);
+    } else if (count == 2)
+    {
+        appendCircle(s, w / 2.0 - (r + 1), r, r, color);
+        appendCircle(s, w / 2.0 + (r + 1), r, r, color);
+    } else if (count == 3)
+    {
+        appendCircle(s, w / 2.0, r, r, color);
+        appendCircle(s, w / 2.0 - (h + 1), r, r, color);
+        appendCircle(s, w / 2.0 + (h + 1), r, r, color);
+    } else
+    {
+        appendCircle(s, w / 2.0 - (r + 1), r, r, color);
+        appendCircle(s, w / 2.0 + (r + 1), r, r, color);
+        appendCircle(s, w / 2.0 - 1.5 * (h + 2), r, r, color);
+        appendCircle(s, w / 2.0 + 1.5 * (h + 2), r, r, color);
+    }
+
+    dotNodes[count] = gtk_snapshot_free_to_node(s);
+    return dotNodes[count];
+}
+
+void DockView::snapshot_vfunc(const Glib::RefPtr<Gtk::Snapshot>& snapshot)
+{
+    GtkSnapshot * s = snapshot->gobj();
+    double sl = bgSize;
+
+    GdkRGBA fg;
+    gtk_widget_get_color(GTK_WIDGET(gobj()), &fg);
+
+    // same alpha as the old .btn:hover / .sep backgrounds
+    GdkRGBA hover = fg;
+    hover.alpha *= 0x5a / 255.0;
+    GdkRGBA line = fg;
+    line.alpha *= 0x3a / 255.0;
+
+    graphene_point_t slide;
+    graphene_point_init(&slide, slideX, slideY);
+
+    gtk_snapshot_save(s);
+    gtk_snapshot_translate(s, &slide);
+
+    snapshot_child(bar, snapshot);
+
+    for (const Slot& slot : slots)
+    {
+        const Item& item = items[slot.item];
+        graphene_rect_t rect;
+
+        if (item.separator)
+        {
+            if (vertical) graphene_rect_init(&rect, slot.x + 8, slot.y, sl - 16, 1);
+            else graphene_rect_init(&rect, slot.x, slot.y + 8, 1, sl - 16);
+
+            gtk_snapshot_append_color(s, &line, &rect);
+            continue;
+        }
+
+        // hover highlight and icon grow around the middle of the item's screen edge side
+        double scale = itemScale(slot);
+
+        if (scale != 1)
+        {
+            graphene_point_t anchor;
+            if (magnifyEdge == Gtk::PositionType::BOTTOM) graphene_point_init(&anchor, slot.x + sl * 0.5, slot.y + sl);
+            else if (magnifyEdge == Gtk::PositionType::TOP) graphene_point_init(&anchor, slot.x + sl * 0.5, slot.y);
+            else if (magnifyEdge == Gtk::PositionType::LEFT) graphene_point_init(&anchor, slot.x, slot.y + sl * 0.5);
+            else graphene_point_init(&anchor, slot.x + sl, slot.y + sl * 0.5);
+
+            graphene_point_t back;
+            graphene_point_init(&back, -anchor.x, -anchor.y);
+
+            gtk_snapshot_save(s);
+            gtk_snapshot_translate(s, &anchor);
+            gtk_snapshot_scale(s, scale, scale);
+            gtk_snapshot_translate(s, &back);
+        }
+
+        if ((int)slot.item == hovered)
+        {
+            graphene_rect_init(&rect, slot.x, slot.y, sl, sl);
+
+            GskRoundedRect clip;
+            gsk_rounded_rect_init_from_rect(&clip, &rect, sl * 0.25);
+
+            gtk_snapshot_push_rounded_clip(s, &clip);
+            gtk_snapshot_append_color(s, &hover, &rect);
+            gtk_snapshot_pop(s);
+        }
+
+        bool pending = false;
+        Glib::RefPtr<Gdk::Texture> tex = texture(item.iconPath, pending);
+        graphene_rect_init(&rect, slot.x + (sl - iconSize) * 0.5, slot.y + (sl - iconSize) * 0.5, iconSize, iconSize);
+
+        if (tex)
+        {
+            gtk_snapshot_append_scaled_texture(s, tex->gobj(), GSK_SCALING_FILTER_TRILINEAR, &rect);
+        } else if (pending)
+        {
+            // still decoding, a faint rounded square keeps the slot from looking empty
+            GskRoundedRect placeholder;
+            gsk_rounded_rect_init_from_rect(&placeholder, &rect, iconSize * 0.25);
+
+            gtk_snapshot_push_rounded_clip(s, &placeholder);
+            gtk_snapshot_append_color(s, &line, &rect);
+            gtk_snapshot_pop(s);
+        }
+
+        if (scale != 1) gtk_snapshot_restore(s);
+
+        if (item.dots > 0)
+        {
+            graphene_point_t p;
+            graphene_point_init(&p, slot.x, slot.y + sl - iconSize / 8.f + 1);
+
+            gtk_snapshot_save(s);
+            gtk_snapshot_translate(s, &p);
+            gtk_snapshot_append_node(s, dotsNode(item.dots, fg));
+            gtk_snapshot_restore(s);
+        }
+    }
+
+    gtk_snapshot_restore(s);
+}
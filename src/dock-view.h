@@ -0,0 +1,132 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <gtkmm-4.0/gtkmm.h>
+#include "animation.h"
+
+/*
+    DockView: the whole row of dock entries as one widget
+    it owns the geometry of every item, does its own hit testing and draws everything in snapshot_vfunc:
+        icons as texture nodes, the hover highlight as a rounded clip, separators as color nodes
+        and the window count dots as one cached render node per dot count
+    so there are no per entry widgets / controllers, a relayout is one pass over the items
+    setSlide() only translates what gets drawn, animations don't cause relayouts either
+    the bar behind the items (.bar child, setBar()) is drawn inside the same translation so it slides out with them
+
+    magnification: icons near the pointer get scaled up (parabolic falloff over MAGNIFY_RANGE items) as snapshot transforms
+    anchored on the screen edge side, the layout and hit testing stay unscaled so nothing moves under the pointer
+    icons are decoded at the magnified size and drawn with mipmapped (trilinear) filtering
+
+    more items than fit into visibleLength: the wheel scrolls one item at a time, the bar gets the css classes
+    overflow-start / overflow-end while there are hidden items on that side
+
+    icons come from the shared texture cache (texture-cache.h), decoded off the main thread, a placeholder is drawn until then
+
+    colors come from the css color of the view (.dock in style.css), the bar is styled as .dock .bar
+    menus of items are popovers parented to the view (see present in size_allocate_vfunc)
+*/
+
+class DockView : public Gtk::Widget
+{
+    public:
+        struct Item
+        {
+            std::string key = "";       // AppEntry::key
+            std::string name = "";      // tooltip
+            std::string iconPath = "";
+            int dots = 0;               // window count
+            bool separator = false;
+        };
+
+        DockView();
+        ~DockView() override;
+
+        // sizes in px, vertical for left / right docks
+        void configure(bool vertical, int iconSize, int bgSize, int padding);
+
+        // replaces all items and lays them out
+        void setItems(const std::vector<Item>& items);
+
+        // px along the edge that are shown, the rest has to be scrolled to
+        void setVisibleLength(int length);
+
+        // scrolls by steps items, returns false if it is already at the end
+        bool scrollBy(int steps);
+
+        // moves the drawn content by dx, dy without a relayout (slide in / out animation)
+        void setSlide(double dx, double dy);
+
+        // where the bar (the dock's background) is drawn, view coordinates, it can reach past the view (padding around the items)
+        void setBar(const Gdk::Rectangle& rect);
+
+        // maxScale <= 1 turns it off, edge is the screen edge the dock sits on (icons grow away from it)
+        void setMagnification(double maxScale, Gtk::PositionType edge);
+
+        // index into the items at x, y (view coordinates, the slide is taken into account), -1 if there is none
+        int itemAt(double x, double y) const;
+
+        // where the item with key is drawn, empty rect if it is scrolled out
+        Gdk::Rectangle itemRect(const std::string& key) const;
+
+        // pointer released over an item
+        std::function<void(const std::string& key, guint button)> onActivate;
+
+        uint64_t layouts = 0;
+
+    protected:
+        void measure_vfunc(Gtk::Orientation orientation, int for_size, int& minimum, int& natural, int& minimum_baseline, int& natural_baseline) const override;
+        void size_allocate_vfunc(int width, int height, int baseline) override;
+        void snapshot_vfunc(const Glib::RefPtr<Gtk::Snapshot>& snapshot) override;
+
+    private:
+        // a visible item and where it is drawn
+        struct Slot
+        {
+            size_t item = 0;
+            double x = 0;
+            double y = 0;
+        };
+
+        std::vector<Item> items = {};
+        std::vector<Slot> slots = {};
+
+        bool vertical = false;
+        int iconSize = 0;
+        int bgSize = 0;
+        int padding = 0;
+        int visibleLength = 0;
+        int scrollFirst = 0;
+        int hovered = -1;
+        double slideX = 0;
+        double slideY = 0;
+
+        Gtk::Box bar;
+        Gdk::Rectangle barRect = Gdk::Rectangle(0, 0, 0, 0);
+
+        static constexpr double MAGNIFY_RANGE = 2.5;   // items from the pointer that still grow
+        double magnifyScale = 1;
+        Gtk::PositionType magnifyEdge = Gtk::PositionType::BOTTOM;
+        double pointer = 0;                             // along the dock, view coordinates
+        Tween magnify;                                  // 0 .. 1, fades the effect in / out on enter / leave
+        Animator animator{*this};
+
+        // references into the texture cache for the shown icons, at the current scale factor (cleared when it changes)
+        std::unordered_map<std::string, Glib::RefPtr<Gdk::Texture>> textures = {};
+        sigc::connection textureReady;
+
+        // dots node per dot count (1 - 4), rebuilt when color or size change
+        std::vector<GskRenderNode *> dotNodes = {};
+        GdkRGBA dotColor = {};
+
+        void layout();
+        double extent(const Item& item) const;
+        double itemScale(const Slot& slot) const;
+        void pointerMoved(double x, double y);
+        void setHovered(int idx);
+        Glib::RefPtr<Gdk::Texture> texture(const std::string& path, bool& pending);
+        GskRenderNode * dotsNode(int count, const GdkRGBA& color);
+        void clearDotNodes();
+};
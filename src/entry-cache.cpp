@@ -0,0 +1,216 @@
+#include "entry-cache.h"
+
+// long enough that unmatched classes don't get ranked every update, short enough to notice newly installed apps
+static const int64_t MISS_TTL = 10 * 60;
+// hits get re-ranked once a day, desktop index changes that don't touch the fingerprint (ranking changes) get picked up
+static const int64_t HIT_TTL = 24 * 60 * 60;
+
+// every new title prefix (browser tabs, terminal titles) is a key, the least recently used ones get dropped past this
+static const size_t MAX_ENTRIES = 512;
+
+// the file gets rewritten at most this often (s), not after every rebuild
+static const int64_t SAVE_INTERVAL = 60;
+
+// titles change all the time (tabs, documents ...), only their beginning is part of the key
+static const size_t TITLE_KEY_LENGTH = 16;
+
+struct CachedEntry
+{
+    DesktopEntry entry;
+    bool miss = false;
+    int64_t resolvedAt = 0;     // unix time
+    int64_t lastUsed = 0;       // unix time, for evicting
+};
+
+static std::unordered_map<std::string, CachedEntry> cache = {};
+static std::string fingerprint = "";
+static bool cacheChanged = false;
+static int64_t lastSave = 0;
+
+static std::filesystem::path cacheFile()
+{
+    const char * xdgCache = std::getenv("XDG_CACHE_HOME");
+
+    if (xdgCache != NULL && xdgCache[0] != '\0') return std::filesystem::path(xdgCache) / "GTKDock" / "entry-cache";
+    return std::filesystem::path(Glib::get_home_dir()) / ".config" / "GTKDock" / "entry-cache";
+}
+
+static int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static bool expired(const CachedEntry& c)
+{
+    return now() - c.resolvedAt > (c.miss ? MISS_TTL : HIT_TTL);
+}
+
+// drops the least recently used entries down to 7/8 of MAX_ENTRIES so this doesn't run on every insert
+static void evict()
+{
+    if (cache.size() <= MAX_ENTRIES) return;
+
+    std::vector<std::pair<int64_t, std::string>> byUse = {};
+    byUse.reserve(cache.size());
+
+    for (const auto& [key, c] : cache)
+        byUse.push_back({ c.lastUsed, key });
+
+    size_t drop = cache.size() - MAX_ENTRIES * 7 / 8;
+    std::nth_element(byUse.begin(), byUse.begin() + drop, byUse.end());
+
+    for (size_t i = 0; i < drop; i++)
+        cache.erase(byUse[i].second);
+
+    cacheChanged = true;
+}
+
+static std::string cacheKey(const AppInstance& inst)
+{
+    return inst.wclass + '\t' + normalizeString(inst.title).substr(0, TITLE_KEY_LENGTH);
+}
+
+// changes whenever a desktop file gets added, removed or modified
+static std::string desktopFilesFingerprint(const DesktopIndex& index)
+{
+    size_t hash = index.entries.size();
+
+    for (const DesktopEntry& dE : index.entries)
+    {
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(dE.desktopFile, ec);
+        int64_t t = ec ? 0 : mtime.time_since_epoch().count();
+
+        hash = hash * 31 + std::hash<std::string>{}(dE.desktopFile);
+        hash = hash * 31 + std::hash<int64_t>{}(t);
+    }
+
+    return std::to_string(hash);
+}
+
+/*
+    file format, one line per key, tab separated:
+        fingerprint
+        wclass  titleKey  desktopFile (empty for misses)  resolvedAt
+*/
+
+void entryCacheLoad(const DesktopIndex& index)
+{
+    cache.clear();
+    fingerprint = desktopFilesFingerprint(index);
+    cacheChanged = false;
+
+    std::ifstream file(cacheFile());
+    std::string line;
+
+    if (!std::getline(file, line) || line != fingerprint)
+    {
+        // desktop files changed since the cache got written
+        cacheChanged = true;
+        return;
+    }
+
+    while (std::getline(file, line))
+    {
+        std::vector<std::string> f = {};
+        size_t start = 0, tab;
+
+        while ((tab = line.find('\t', start)) != std::string::npos)
+        {
+            f.push_back(line.substr(start, tab - start));
+            start = tab + 1;
+        }
+        f.push_back(line.substr(start));
+
+        if (f.size() != 4) continue;
+
+        CachedEntry c;
+        c.miss = f[2].empty();
+        c.resolvedAt = c.lastUsed = std::atoll(f[3].c_str());
+
+        if (expired(c)) continue;
+
+        if (!c.miss)
+        {
+            int i = index.find(f[2]);
+            if (i < 0) continue;
+            c.entry = index.entries[i];
+        }
+
+        cache[f[0] + '\t' + f[1]] = c;
+    }
+
+    evict();
+}
+
+void entryCacheInvalidate(const DesktopIndex& index)
+{
+    cache.clear();
+    fingerprint = desktopFilesFingerprint(index);
+    cacheChanged = true;
+}
+
+DesktopEntry resolveEntryCached(const std::vector<AppInstance>& instances, const DesktopIndex& index)
+{
+    std::string key = cacheKey(instances[0]);
+    auto it = cache.find(key);
+
+    if (it != cache.end() && !expired(it->second))
+    {
+        // only kept in memory, not worth a rewrite of the file
+        it->second.lastUsed = now();
+        return it->second.entry;
+    }
+
+    CachedEntry c;
+    c.entry = getEntryOfInstances(instances, index);
+    c.miss = c.entry.desktopFile.empty();
+    c.resolvedAt = c.lastUsed = now();
+
+    cache[key] = c;
+    cacheChanged = true;
+    evict();
+
+    return c.entry;
+}
+
+void entryCacheSave()
+{
+    if (!cacheChanged || now() - lastSave < SAVE_INTERVAL) return;
+    lastSave = now();
+
+    std::filesystem::path path = cacheFile();
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    // write to a temp file first so a crash never leaves half a cache behind
+    std::filesystem::path tmp = path;
+    tmp += ".tmp";
+
+    std::ofstream file(tmp);
+    if (!file.is_open())
+    {
+        std::cerr << "Unable to write " << path << std::endl;
+        return;
+    }
+
+    file << fingerprint << "\n";
+
+    for (const auto& pair : cache)
+    {
+        // keys with tabs / newlines (odd titles) would break the line format, they just don't get persisted
+        if (pair.first.find('\n') != std::string::npos || std::count(pair.first.begin(), pair.first.end(), '\t') != 1) continue;
+
+        file << pair.first << "\t" << (pair.second.miss ? "" : pair.second.entry.desktopFile) << "\t" << pair.second.resolvedAt << "\n";
+    }
+
+    file.close();
+    std::filesystem::rename(tmp, path, ec);
+
+    cacheChanged = false;
+}
+
+bool entryCacheUnsaved()
+{
+    return cacheChanged;
+}
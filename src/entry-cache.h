@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "utils.h"
+#include "desktop-index.h"
+
+/*
+    class -> DesktopEntry resolution cache
+    getEntryOfInstances() results get remembered
+    keyed by (wclass, normalized title prefix), misses included (they expire after a while since the app may get installed)
+    hits expire too (once a day), past MAX_ENTRIES keys the least recently used ones get dropped
+
+    persisted to $XDG_CACHE_HOME/GTKDock/entry-cache (~/.config/GTKDock/entry-cache without XDG_CACHE_HOME)
+    together with a fingerprint of the desktop files, a different fingerprint drops the whole cache
+    only used from the entry pipeline worker
+*/
+
+// loads the persisted cache for this set of desktop files
+void entryCacheLoad(const DesktopIndex& index);
+
+// desktop files got added / removed / edited: forget everything
+void entryCacheInvalidate(const DesktopIndex& index);
+
+// cached getEntryOfInstances(), a single hash lookup once a class has been seen
+DesktopEntry resolveEntryCached(const std::vector<AppInstance>& instances, const DesktopIndex& index);
+
+// writes the cache back if it changed, at most every SAVE_INTERVAL seconds (calling it after every rebuild is fine)
+void entryCacheSave();
+
+// true while there are changes entryCacheSave() hasn't written yet
+bool entryCacheUnsaved();
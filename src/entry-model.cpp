@@ -0,0 +1,137 @@
+#include "entry-model.h"
+
+bool EntryDiff::empty() const
+{
+    return added.empty() && removed.empty() && changed.empty() && !moved;
+}
+
+const AppEntry * EntryModel::find(const std::string& key) const
+{
+    for (const AppEntry& e : current)
+    {
+        if (e.key == key) return &e;
+    }
+    return nullptr;
+}
+
+// position of every key in list, first occurrence wins
+template <typename T, typename KeyFn>
+static std::unordered_map<std::string, size_t> positions(const std::vector<T>& list, KeyFn key)
+{
+    std::unordered_map<std::string, size_t> res = {};
+
+    for (size_t i = 0; i < list.size(); i++)
+        res.emplace(key(list[i]), i);
+
+    return res;
+}
+
+// keys seen before keep their relative order, new ones go after them in the order they came in
+template <typename T, typename KeyFn>
+static void keepOrder(std::vector<T>& list, const std::unordered_map<std::string, size_t>& before, KeyFn key)
+{
+    std::stable_sort(list.begin(), list.end(), [&before, &key](const T& a, const T& b) {
+        auto ia = before.find(key(a));
+        auto ib = before.find(key(b));
+        size_t pa = (ia == before.end()) ? SIZE_MAX : ia->second;
+        size_t pb = (ib == before.end()) ? SIZE_MAX : ib->second;
+        return pa < pb;
+    });
+}
+
+void EntryModel::arrange(std::vector<AppEntry>& running) const
+{
+    for (AppEntry& e : running)
+    {
+        const AppEntry * prev = find(e.key);
+        if (prev == nullptr) continue;
+
+        keepOrder(e.instances, positions(prev->instances, instanceKey), instanceKey);
+    }
+
+    if (order == EntryOrder::NAME)
+    {
+        std::stable_sort(running.begin(), running.end(), [](const AppEntry& a, const AppEntry& b) {
+            return normalizeString(a.app.name) < normalizeString(b.app.name);
+        });
+        return;
+    }
+
+    auto key = [](const AppEntry& e) { return e.key; };
+    keepOrder(running, positions(current, key), key);
+}
+
+// anything the dock shows for an entry
+static bool sameEntry(const AppEntry& a, const AppEntry& b)
+{
+    return a.count_instances == b.count_instances && a.isPinned == b.isPinned
+        && a.app.name == b.app.name && a.app.iconPath == b.app.iconPath && a.app.execCmd == b.app.execCmd
+        && identicalInstances(a.instances, b.instances);
+}
+
+EntryDiff EntryModel::commit(std::vector<AppEntry>& entries)
+{
+    for (AppEntry& e : entries)
+    {
+        const AppEntry * prev = find(e.key);
+        e.generation = (prev != nullptr && sameEntry(*prev, e)) ? prev->generation : ++generation;
+    }
+
+    // the worker only needs to know whether anything changed, the ui works out the window changes for itself
+    EntryDiff diff = diffEntries(current, entries, false);
+    current = entries;
+    return diff;
+}
+
+EntryDiff diffEntries(const std::vector<AppEntry>& from, const std::vector<AppEntry>& to, bool withInstances)
+{
+    EntryDiff diff;
+    auto key = [](const AppEntry& e) { return e.key; };
+    auto fromPos = positions(from, key);
+    auto toPos = positions(to, key);
+
+    for (const AppEntry& e : from)
+    {
+        if (toPos.count(e.key) == 0) diff.removed.push_back(e.key);
+    }
+
+    // common keys in the order of to, used to tell if they moved relative to each other
+    size_t lastFromPos = 0;
+    bool first = true;
+
+    for (const AppEntry& e : to)
+    {
+        auto it = fromPos.find(e.key);
+
+        if (it == fromPos.end())
+        {
+            diff.added.push_back(e.key);
+            continue;
+        }
+
+        if (!first && it->second < lastFromPos) diff.moved = true;
+        lastFromPos = it->second;
+        first = false;
+
+        const AppEntry& prev = from[it->second];
+        if (prev.generation == e.generation) continue;
+
+        diff.changed.push_back(e.key);
+        if (!withInstances) continue;
+
+        auto before = positions(prev.instances, instanceKey);
+        auto after = positions(e.instances, instanceKey);
+
+        for (const AppInstance& i : e.instances)
+        {
+            if (before.count(instanceKey(i)) == 0) diff.instancesAdded.push_back({ e.key, instanceKey(i) });
+        }
+
+        for (const AppInstance& i : prev.instances)
+        {
+            if (after.count(instanceKey(i)) == 0) diff.instancesRemoved.push_back({ e.key, instanceKey(i) });
+        }
+    }
+
+    return diff;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "utils.h"
+
+/*
+    entry model: the entry list the dock shows, kept across rebuilds by the entry pipeline worker
+    every entry has a stable key (AppEntry::key), running entries keep their place once seen (or get sorted by name)
+    and carry a generation that only changes when something shown for the entry changes
+
+    two lists are compared by key + generation (diffEntries) so neither a reordered hash map
+    nor an unrelated window changes what the ui has to redo
+*/
+
+enum class EntryOrder
+{
+    FIRST_SEEN = 0,     // new apps get appended, apps keep their place while running
+    NAME                // alphabetical by app name
+};
+
+// what changed between two entry lists
+struct EntryDiff
+{
+    std::vector<std::string> added = {};        // entry keys
+    std::vector<std::string> removed = {};
+    std::vector<std::string> changed = {};      // in both lists with a different generation
+    // (entry key, instanceKey) of changed entries, the window lists of the dock's menus get updated by them
+    std::vector<std::pair<std::string, std::string>> instancesAdded = {};
+    std::vector<std::pair<std::string, std::string>> instancesRemoved = {};
+    bool moved = false;                         // entries in both lists are in a different order
+
+    bool empty() const;
+};
+
+struct EntryModel
+{
+    EntryOrder order = EntryOrder::FIRST_SEEN;
+
+    // brings the running entries into display order, instances inside an entry keep their order the same way
+    void arrange(std::vector<AppEntry>& running) const;
+
+    // stamps generations on the final list (unchanged entries keep theirs), makes it the current list
+    // and returns what changed compared to the previous one
+    EntryDiff commit(std::vector<AppEntry>& entries);
+
+    private:
+        std::vector<AppEntry> current = {};
+        uint64_t generation = 0;
+
+        const AppEntry * find(const std::string& key) const;
+};
+
+// keyed diff, entries with the same key and generation count as unchanged
+// withInstances = false leaves instancesAdded / instancesRemoved empty (no per window set diffs)
+EntryDiff diffEntries(const std::vector<AppEntry>& from, const std::vector<AppEntry>& to, bool withInstances = true);
@@ -0,0 +1,320 @@
+#include "entry-pipeline.h"
+#include "entry-cache.h"
+#include "desktop-index.h"
+#include "pid-resolver.h"
+#include "entry-model.h"
+#include "icon-index.h"
+#include <mutex>
+#include <condition_variable>
+
+/*
+    pendingInstances / dirty: input of the worker, guarded by pipelineMutex
+    published: output of the worker, swapped atomically so readers never lock
+*/
+
+static std::mutex pipelineMutex;
+static std::condition_variable pipelineCond;
+static std::vector<AppInstance> pendingInstances = {};
+static bool dirty = false;
+static bool desktopFilesChanged = false;
+
+// seconds an idle worker waits before writing unsaved entry cache changes (a bit past the cache's save interval)
+static const int ENTRY_CACHE_FLUSH = 61;
+
+static std::atomic<uint64_t> instancesReceived(0);
+static std::atomic<uint64_t> entriesBuilt(0);
+static std::atomic<uint64_t> snapshotsPublished(0);
+
+static EntryPipelineConfig pipelineConfig;
+static DesktopIndex desktopIndex;
+static EntryModel entryModel;
+static std::atomic<EntrySnapshot> published(std::make_shared<const std::vector<AppEntry>>());
+static Glib::Dispatcher * changedDispatcher = nullptr;
+
+bool pushInstances(const std::vector<AppInstance>& instances)
+{
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        // pollers push the same list over and over, don't wake the worker for that
+        if (identicalInstances(pendingInstances, instances)) return false;
+
+        pendingInstances = instances;
+        dirty = true;
+    }
+    instancesReceived++;
+    pipelineCond.notify_one();
+    return true;
+}
+
+void refreshEntries()
+{
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        dirty = true;
+    }
+    pipelineCond.notify_one();
+}
+
+void rescanDesktopFiles()
+{
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        desktopFilesChanged = true;
+        dirty = true;
+    }
+    pipelineCond.notify_one();
+}
+
+/*
+    getEntries returns a vector of all wm managed applications each entry has a vector instances(windows) that share the same class
+    instances vector gets used to find desktop file which then fills out the rest of the AppEntry struct using parseDesktopFile()
+    icon gets found in the icon index (see icon-index.h) by findIconPath()
+    classes resolving to the same desktop file share one entry, the entry model decides the order
+*/
+
+// /proc knows exactly which app a window belongs to, class / title matching is the fallback
+static DesktopEntry resolveEntry(const std::vector<AppInstance>& instances)
+{
+    for (const AppInstance& inst : instances)
+    {
+        int i = resolvePid(inst.pid, desktopIndex);
+        if (i >= 0) return desktopIndex.entries[i];
+    }
+
+    return resolveEntryCached(instances, desktopIndex);
+}
+
+static std::vector<AppEntry> getEntries(const std::vector<AppInstance>& instances, const EntryPipelineConfig& config)
+{
+    bool singleInstance = getIfThisIsOnlyInstance();
+    // classes in the order their first window came in
+    std::vector<std::vector<AppInstance>> classes = {};
+    std::unordered_map<std::string, size_t> classIdx = {};
+
+    for (const AppInstance& inst : instances)
+    {
+        if (!singleInstance && (inst.monitorIdx != config.monitorIdx)) continue;
+
+        auto it = classIdx.emplace(inst.wclass, classes.size()).first;
+        if (it->second == classes.size()) classes.push_back({});
+        classes[it->second].push_back(inst);
+    }
+
+    std::vector<AppEntry> res = {};
+    std::unordered_map<std::string, size_t> entryIdx = {};
+
+    for (const auto& classInstances : classes)
+    {
+        DesktopEntry app = resolveEntry(classInstances);
+        std::string key = app.desktopFile.empty() ? "class:" + classInstances[0].wclass : app.desktopFile;
+
+        auto it = entryIdx.emplace(key, res.size()).first;
+        if (it->second == res.size())
+        {
+            AppEntry e;
+            e.app = app;
+            e.key = key;
+            res.push_back(e);
+        }
+
+        AppEntry& e = res[it->second];
+        e.instances.insert(e.instances.end(), classInstances.begin(), classInstances.end());
+        e.count_instances = e.instances.size();
+    }
+
+    entryModel.arrange(res);
+    return res;
+}
+
+// getEntries + pinned apps in front (separated by a "line" entry) + launcher at the end
+static std::vector<AppEntry> loadEntries(const std::vector<AppInstance>& instances, const EntryPipelineConfig& config)
+{
+    std::vector<AppEntry> entries = getEntries(instances, config);
+
+    std::vector <AppEntry> pinned = {};
+    std::ifstream file(getRes("conf/pinnedApps"));
+
+    // Check if the file was opened successfully
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open Pinned apps file " << std::endl;
+    }
+
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        std::vector<std::string> values = splitStr(line, ":");
+
+        AppEntry e = {0, true, values[0], values[1], values[2], values[3]};
+        e.count_instances = 0;
+        e.key = e.app.desktopFile.empty() ? "pinned:" + e.app.name : e.app.desktopFile;
+        pinned.push_back(e);
+    }
+
+    file.close();
+
+    for (AppEntry& pentry : pinned)
+    {
+        int i = 0;
+        for (AppEntry& entry : entries)
+        {
+            if (pentry.app.name == entry.app.name)
+            {
+                entry.isPinned = true;
+                pentry = entry;
+                entries.erase(entries.begin()+i);
+            }
+            i++;
+        }
+    }
+
+    if (pinned.size() > 0 && entries.size() > 0)
+    {
+        pinned.push_back( {0, false, "line"} );
+        pinned.back().key = "line";
+    }
+    entries.insert(entries.begin(), pinned.begin(), pinned.end());
+
+    if (config.drawLauncher)
+    {
+        entries.push_back( {
+            0, true, "Launcher", config.launcherCmd, getRes("imgs/launcher.png")
+        } );
+        entries.back().key = "launcher";
+    }
+
+    return entries;
+}
+
+// publishes entries if the model says they differ from the current snapshot, returns true if they did
+static bool publish(std::vector<AppEntry>&& entries)
+{
+    if (entryModel.commit(entries).empty()) return false;
+
+    published.store(std::make_shared<const std::vector<AppEntry>>(std::move(entries)));
+    snapshotsPublished++;
+    return true;
+}
+
+static void workerLoop()
+{
+    while (true)
+    {
+        std::vector<AppInstance> instances;
+
+        {
+            std::unique_lock<std::mutex> lock(pipelineMutex);
+
+            // entryCacheSave() is debounced, an idle dock still gets the last changes written once the interval passed
+            while (entryCacheUnsaved() && !pipelineCond.wait_for(lock, std::chrono::seconds(ENTRY_CACHE_FLUSH), [](){ return dirty; }))
+            {
+                lock.unlock();
+                entryCacheSave();
+                lock.lock();
+            }
+
+            pipelineCond.wait(lock, [](){ return dirty; });
+        }
+
+        // a workspace switch / closing a multi window app comes as a burst of changes
+        // let the rest of it arrive so the whole burst costs one rebuild
+        if (pipelineConfig.coalesceMs > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(pipelineConfig.coalesceMs));
+
+        bool rescan = false;
+
+        {
+            std::lock_guard<std::mutex> lock(pipelineMutex);
+            dirty = false;
+            instances = pendingInstances;
+            rescan = desktopFilesChanged;
+            desktopFilesChanged = false;
+        }
+
+        if (rescan)
+        {
+            // new apps install their icons too, has to be current before the desktop files resolve them
+            iconIndexRecheck();
+            pipelineConfig.desktopFiles = findDesktopFiles();
+            desktopIndex.build(pipelineConfig.desktopFiles);
+            entryCacheInvalidate(desktopIndex);
+            pidResolverClear();
+        }
+
+        // the slow part (/proc scan, desktop entry ranking) runs without holding any lock
+        entriesBuilt++;
+        if (publish(loadEntries(instances, pipelineConfig))) changedDispatcher->emit();
+
+        pidResolverPrune(instances);
+        entryCacheSave();
+    }
+}
+
+// installing / removing apps touches many files at once, rescan once things settled down
+static void watchDesktopFiles()
+{
+    static std::vector<Glib::RefPtr<Gio::FileMonitor>> monitors = {};
+    static sigc::connection rescanTimer;
+
+    for (const auto& path : searchPaths)
+    {
+        if (!std::filesystem::is_directory(path)) continue;
+
+        try
+        {
+            auto monitor = Gio::File::create_for_path(path.string())->monitor_directory();
+
+            monitor->signal_changed().connect([](const Glib::RefPtr<Gio::File>&, const Glib::RefPtr<Gio::File>&, Gio::FileMonitor::Event) {
+                if (rescanTimer.connected()) return;
+
+                rescanTimer = Glib::signal_timeout().connect_seconds([]() {
+                    rescanDesktopFiles();
+                    return false;
+                }, 1);
+            });
+
+            monitors.push_back(monitor);
+        } catch (const Glib::Error& e)
+        {
+            std::cerr << "Couldn't watch " << path << ": " << e.what() << std::endl;
+        }
+    }
+}
+
+void startEntryPipeline(const EntryPipelineConfig& config, const std::function<void()>& onChanged)
+{
+    pipelineConfig = config;
+    entryModel.order = config.order;
+
+    // Dispatcher has to be created on the thread whose main loop runs the handler
+    changedDispatcher = new Glib::Dispatcher();
+    changedDispatcher->connect(onChanged);
+
+    std::vector<AppInstance> instances;
+    {
+        std::lock_guard<std::mutex> lock(pipelineMutex);
+        instances = pendingInstances;
+        dirty = false;
+    }
+
+    desktopIndex.build(pipelineConfig.desktopFiles);
+    entryCacheLoad(desktopIndex);
+
+    // first dock build needs entries right away
+    publish(loadEntries(instances, pipelineConfig));
+    entryCacheSave();
+
+    watchDesktopFiles();
+
+    std::thread(workerLoop).detach();
+}
+
+EntrySnapshot currentEntries()
+{
+    return published.load();
+}
+
+EntryPipelineStats entryPipelineStats()
+{
+    return { instancesReceived.load(), entriesBuilt.load(), snapshotsPublished.load() };
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include "utils.h"
+#include "entry-model.h"
+
+/*
+    entry pipeline: turns the instance list into the AppEntry list the dock shows
+    (group by class -> find desktop entries -> order with pinned apps / launcher) on a worker thread
+    so the gtk main thread never waits on /proc scans, icon lookups or list_windows.bash
+
+    the result is published as an immutable snapshot (atomic shared_ptr swap),
+    the ui gets woken through a Glib::Dispatcher only if the entry model saw an actual change
+*/
+
+struct EntryPipelineConfig
+{
+    bool isolated = false;
+    int monitorIdx = 0;
+    bool drawLauncher = false;
+    std::string launcherCmd = "";
+    std::vector<DesktopEntry> desktopFiles = {};
+    int coalesceMs = 30;    // changes arriving this long after the first one get folded into the same rebuild
+    EntryOrder order = EntryOrder::FIRST_SEEN;
+};
+
+// counters to see how well bursts get coalesced
+struct EntryPipelineStats
+{
+    uint64_t instancesReceived = 0;     // pushInstances calls with a changed list
+    uint64_t entriesBuilt = 0;          // loadEntries runs on the worker
+    uint64_t snapshotsPublished = 0;    // builds that actually changed the dock
+};
+
+typedef std::shared_ptr<const std::vector<AppEntry>> EntrySnapshot;
+
+// new instance list from a backend / list_windows.bash, may be called from any thread (also before the pipeline started)
+// returns false if it is identical to the previous one
+bool pushInstances(const std::vector<AppInstance>& instances);
+
+// rebuild entries even though instances didn't change (pinnedApps got edited ...)
+void refreshEntries();
+
+// re-reads the desktop files (and the icons they name) before the next rebuild, ex. after the icon theme changed
+void rescanDesktopFiles();
+
+// builds the first snapshot synchronously, then starts the worker
+// onChanged runs on the gtk main thread after a new snapshot got published, has to be called from the main thread
+void startEntryPipeline(const EntryPipelineConfig& config, const std::function<void()>& onChanged);
+
+// latest published snapshot, never blocks
+EntrySnapshot currentEntries();
+
+EntryPipelineStats entryPipelineStats();
@@ -0,0 +1,291 @@
+#include "foreign-toplevel.h"
+#include "backend.h"
+#include <gdk/wayland/gdkwayland.h>
+#include <wayland-client.h>
+#include "wlr-foreign-toplevel-management-unstable-v1-client-protocol.h"
+
+/*
+    ForeignToplevel: one toplevel handle, events are double buffered in pending and applied to current on done
+*/
+
+struct ForeignToplevel
+{
+    zwlr_foreign_toplevel_handle_v1 * handle = nullptr;
+    AppInstance current;
+    AppInstance pending;
+    std::vector<wl_output *> outputs = {};
+    bool mapped = false;
+};
+
+static wl_registry * registry = nullptr;
+static zwlr_foreign_toplevel_manager_v1 * manager = nullptr;
+static std::vector<ForeignToplevel *> toplevels = {};
+static std::function<void(const std::vector<AppInstance>&)> changeCallback;
+static uint64_t nextToplevelId = 1;
+
+static int monitorIdxOfOutput(wl_output * output)
+{
+    auto monitors = Gdk::Display::get_default()->get_monitors();
+
+    for (guint i = 0; i < monitors->get_n_items(); i++)
+    {
+        GdkMonitor * monitor = GDK_MONITOR(monitors->get_object(i)->gobj());
+        if (GDK_IS_WAYLAND_MONITOR(monitor) && gdk_wayland_monitor_get_wl_output(monitor) == output)
+            return i;
+    }
+
+    return 0;
+}
+
+std::vector<AppInstance> foreignToplevelGetInstances()
+{
+    std::vector<AppInstance> inst = {};
+
+    for (ForeignToplevel * t : toplevels)
+    {
+        if (t->mapped) inst.push_back(t->current);
+    }
+
+    return inst;
+}
+
+static void publish()
+{
+    if (changeCallback) changeCallback(foreignToplevelGetInstances());
+}
+
+static ForeignToplevel * findToplevel(const std::string& id)
+{
+    for (ForeignToplevel * t : toplevels)
+    {
+        if (t->current.id == id) return t;
+    }
+
+    return nullptr;
+}
+
+static void handleTitle(void * data, zwlr_foreign_toplevel_handle_v1 *, const char * title)
+{
+    auto * t = static_cast<ForeignToplevel *>(data);
+    t->pending.title = (title == NULL || title[0] == '\0') ? "-" : title;
+}
+
+static void handleAppId(void * data, zwlr_foreign_toplevel_handle_v1 *, const char * app_id)
+{
+    auto * t = static_cast<ForeignToplevel *>(data);
+    t->pending.wclass = (app_id == NULL || app_id[0] == '\0') ? "-" : app_id;
+}
+
+static void handleOutputEnter(void * data, zwlr_foreign_toplevel_handle_v1 *, wl_output * output)
+{
+    auto * t = static_cast<ForeignToplevel *>(data);
+    t->outputs.push_back(output);
+}
+
+static void handleOutputLeave(void * data, zwlr_foreign_toplevel_handle_v1 *, wl_output * output)
+{
+    auto * t = static_cast<ForeignToplevel *>(data);
+    t->outputs.erase(std::remove(t->outputs.begin(), t->outputs.end(), output), t->outputs.end());
+}
+
+static void handleState(void * data, zwlr_foreign_toplevel_handle_v1 *, wl_array * state)
+{
+    auto * t = static_cast<ForeignToplevel *>(data);
+    const uint32_t * states = static_cast<const uint32_t *>(state->data);
+
+    t->pending.fullscreen = false;
+    for (size_t i = 0; i < state->size / sizeof(uint32_t); i++)
+    {
+        if (states[i] == ZWLR_FOREIGN_TOPLEVEL_HANDLE_V1_STATE_FULLSCREEN)
+            t->pending.fullscreen = true;
+    }
+}
+
+static void handleDone(void * data, zwlr_foreign_toplevel_handle_v1 *)
+{
+    auto * t = static_cast<ForeignToplevel *>(data);
+    t->pending.monitorIdx = t->outputs.empty() ? 0 : monitorIdxOfOutput(t->outputs[0]);
+
+    bool changed = !t->mapped || t->pending.title != t->current.title || t->pending.wclass != t->current.wclass
+        || t->pending.fullscreen != t->current.fullscreen || t->pending.monitorIdx != t->current.monitorIdx;
+
+    t->current = t->pending;
+    t->mapped = true;
+
+    if (changed) publish();
+}
+
+static void handleClosed(void * data, zwlr_foreign_toplevel_handle_v1 * handle)
+{
+    auto * t = static_cast<ForeignToplevel *>(data);
+    bool wasMapped = t->mapped;
+
+    toplevels.erase(std::remove(toplevels.begin(), toplevels.end(), t), toplevels.end());
+    zwlr_foreign_toplevel_handle_v1_destroy(handle);
+    delete t;
+
+    if (wasMapped) publish();
+}
+
+static void handleParent(void *, zwlr_foreign_toplevel_handle_v1 *, zwlr_foreign_toplevel_handle_v1 *)
+{
+}
+
+static const zwlr_foreign_toplevel_handle_v1_listener toplevelListener = {
+    handleTitle,
+    handleAppId,
+    handleOutputEnter,
+    handleOutputLeave,
+    handleState,
+    handleDone,
+    handleClosed,
+    handleParent
+};
+
+static void handleToplevel(void *, zwlr_foreign_toplevel_manager_v1 *, zwlr_foreign_toplevel_handle_v1 * handle)
+{
+    auto * t = new ForeignToplevel();
+    t->handle = handle;
+    t->pending.id = "toplevel-" + std::to_string(nextToplevelId++);
+    t->pending.pid = -1;
+
+    toplevels.push_back(t);
+    zwlr_foreign_toplevel_handle_v1_add_listener(handle, &toplevelListener, t);
+}
+
+static void handleFinished(void *, zwlr_foreign_toplevel_manager_v1 * mgr)
+{
+    zwlr_foreign_toplevel_manager_v1_destroy(mgr);
+    manager = nullptr;
+}
+
+static const zwlr_foreign_toplevel_manager_v1_listener managerListener = {
+    handleToplevel,
+    handleFinished
+};
+
+static void handleGlobal(void *, wl_registry * reg, uint32_t name, const char * interface, uint32_t version)
+{
+    if (manager == nullptr && strcmp(interface, zwlr_foreign_toplevel_manager_v1_interface.name) == 0)
+    {
+        manager = static_cast<zwlr_foreign_toplevel_manager_v1 *>(wl_registry_bind(reg, name, &zwlr_foreign_toplevel_manager_v1_interface, std::min(version, 3u)));
+        zwlr_foreign_toplevel_manager_v1_add_listener(manager, &managerListener, nullptr);
+    }
+}
+
+static void handleGlobalRemove(void *, wl_registry *, uint32_t)
+{
+}
+
+static const wl_registry_listener registryListener = {
+    handleGlobal,
+    handleGlobalRemove
+};
+
+bool foreignToplevelInit(const std::function<void(const std::vector<AppInstance>&)>& onChange)
+{
+    GdkDisplay * display = Gdk::Display::get_default()->gobj();
+    if (!GDK_IS_WAYLAND_DISPLAY(display)) return false;
+
+    wl_display * wl = gdk_wayland_display_get_wl_display(display);
+
+    registry = wl_display_get_registry(wl);
+    wl_registry_add_listener(registry, &registryListener, nullptr);
+    wl_display_roundtrip(wl);
+
+    if (manager == nullptr)
+    {
+        wl_registry_destroy(registry);
+        registry = nullptr;
+        return false;
+    }
+
+    changeCallback = onChange;
+
+    // receive the initial toplevels and their state before the dock gets built
+    wl_display_roundtrip(wl);
+    publish();
+    return true;
+}
+
+bool foreignToplevelActive()
+{
+    return manager != nullptr;
+}
+
+void foreignToplevelActivate(const std::string& id)
+{
+    ForeignToplevel * t = findToplevel(id);
+    if (t == nullptr) return;
+
+    GdkDisplay * display = Gdk::Display::get_default()->gobj();
+    wl_seat * seat = gdk_wayland_seat_get_wl_seat(gdk_display_get_default_seat(display));
+
+    zwlr_foreign_toplevel_handle_v1_activate(t->handle, seat);
+    wl_display_flush(gdk_wayland_display_get_wl_display(display));
+}
+
+void foreignToplevelClose(const std::string& id)
+{
+    ForeignToplevel * t = findToplevel(id);
+    if (t == nullptr) return;
+
+    zwlr_foreign_toplevel_handle_v1_close(t->handle);
+    wl_display_flush(gdk_wayland_display_get_wl_display(Gdk::Display::get_default()->gobj()));
+}
+
+/*
+    built in gtkdock_backend, events already arrive on the gtk main thread so there is no watcher thread
+*/
+
+static int foreignToplevelProbe()
+{
+    return foreignToplevelActive() || foreignToplevelInit(nullptr);
+}
+
+static void foreignToplevelEnumerate(gtkdock_instances_cb cb, void * user_data)
+{
+    emitInstances(foreignToplevelGetInstances(), cb, user_data);
+}
+
+static int foreignToplevelSubscribe(gtkdock_instances_cb cb, void * user_data)
+{
+    changeCallback = [cb, user_data](const std::vector<AppInstance>& instances) {
+        emitInstances(instances, cb, user_data);
+    };
+    return 0;
+}
+
+static void foreignToplevelUnsubscribe()
+{
+    changeCallback = nullptr;
+}
+
+static void foreignToplevelActivateId(const char * id)
+{
+    foreignToplevelActivate(id);
+}
+
+static void foreignToplevelCloseIds(const char * const * ids, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        foreignToplevelClose(ids[i]);
+}
+
+static const gtkdock_backend foreignToplevel = {
+    GTKDOCK_BACKEND_ABI_VERSION,
+    "wlr-foreign-toplevel",
+    foreignToplevelProbe,
+    foreignToplevelEnumerate,
+    foreignToplevelSubscribe,
+    foreignToplevelUnsubscribe,
+    foreignToplevelActivateId,
+    foreignToplevelCloseIds,
+    NULL,
+    NULL
+};
+
+const gtkdock_backend * foreignToplevelBackend()
+{
+    return &foreignToplevel;
+}
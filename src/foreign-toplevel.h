@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include "utils.h"
+#include "dock-backend.h"
+
+/*
+    wlr-foreign-toplevel-management backend
+    binds zwlr_foreign_toplevel_manager_v1 on the docks own wayland connection (the one gdk uses)
+    so every wlroots based compositor pushes window changes to us, events get dispatched on the gtk main thread
+*/
+
+// binds the toplevel manager, onChange gets called with the full instance list after every done / closed event
+// returns false if the session isn't wayland or the compositor doesn't offer the protocol
+bool foreignToplevelInit(const std::function<void(const std::vector<AppInstance>&)>& onChange);
+
+// true once foreignToplevelInit() succeeded and the compositor hasn't sent finished
+bool foreignToplevelActive();
+
+// current instance list as last reported by the compositor
+std::vector<AppInstance> foreignToplevelGetInstances();
+
+// ask the compositor to focus / close the toplevel with AppInstance::id == id (main thread only)
+void foreignToplevelActivate(const std::string& id);
+void foreignToplevelClose(const std::string& id);
+
+// the above as a gtkdock_backend (see backend.h)
+const gtkdock_backend * foreignToplevelBackend();
@@ -0,0 +1,539 @@
+#include "hyprland-ipc.h"
+#include "backend.h"
+#include "json.h"
+#include "window-geometry.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <poll.h>
+#include <cerrno>
+#include <unordered_map>
+
+static std::string hyprlandSocketDir()
+{
+    const char * sig = std::getenv("HYPRLAND_INSTANCE_SIGNATURE");
+    if (sig == NULL) return "";
+
+    const char * runtime = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime != NULL)
+    {
+        std::string dir = std::string(runtime) + "/hypr/" + sig;
+        if (std::filesystem::exists(dir + "/.socket.sock"))
+            return dir;
+    }
+
+    // hyprland versions before 0.40 kept their sockets in /tmp
+    return std::string("/tmp/hypr/") + sig;
+}
+
+// hyprland events carry addresses without the 0x prefix that j/clients and dispatchers use
+static std::string normalizeAddress(const std::string& address)
+{
+    if (address.rfind("0x", 0) == 0) return address;
+    return "0x" + address;
+}
+
+// splits event data on ',' into at most n fields, the last field keeps any remaining commas (titles)
+static std::vector<std::string> splitFields(const std::string& data, size_t n)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+
+    while (fields.size() + 1 < n)
+    {
+        size_t pos = data.find(',', start);
+        if (pos == std::string::npos) break;
+
+        fields.push_back(data.substr(start, pos - start));
+        start = pos + 1;
+    }
+
+    fields.push_back(data.substr(start));
+    fields.resize(n);
+    return fields;
+}
+
+bool hyprlandIpcAvailable()
+{
+    if (std::getenv("HYPRLAND_INSTANCE_SIGNATURE") == NULL) return false;
+    return std::filesystem::exists(hyprlandSocketDir() + "/.socket.sock");
+}
+
+std::string hyprlandRequest(const std::string& request)
+{
+    int fd = connectUnixSocket(hyprlandSocketDir() + "/.socket.sock");
+    if (fd < 0) return "";
+
+    size_t written = 0;
+    while (written < request.size())
+    {
+        ssize_t n = send(fd, request.c_str() + written, request.size() - written, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0)
+        {
+            close(fd);
+            return "";
+        }
+        written += n;
+    }
+
+    std::string reply;
+    char buffer[BUFSIZ];
+
+    while (true)
+    {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        reply.append(buffer, n);
+    }
+
+    close(fd);
+    return reply;
+}
+
+std::string hyprlandBatch(const std::vector<std::string>& requests)
+{
+    std::string batch = "[[BATCH]]";
+
+    for (const std::string& r : requests)
+        batch += r + ";";
+
+    return hyprlandRequest(batch);
+}
+
+static AppInstance instanceFromClient(const JsonValue& client)
+{
+    AppInstance i;
+    i.monitorIdx = client["monitor"].asInt(0);
+    i.title = client["title"].asString();
+    i.wclass = client["class"].asString();
+    // bool on older hyprland, fullscreen mode (0-3) on newer ones
+    i.fullscreen = client["fullscreen"].asBool();
+    i.pid = client["pid"].asInt(-1);
+    i.id = client["address"].asString();
+
+    // same placeholders list_windows.bash results get
+    if (i.title.empty()) i.title = "-";
+    if (i.wclass.empty()) i.wclass = "-";
+
+    return i;
+}
+
+std::vector<AppInstance> hyprlandGetClients()
+{
+    std::vector<AppInstance> inst = {};
+    JsonValue clients = parseJson(hyprlandRequest("j/clients"));
+
+    for (const JsonValue& c : clients.items)
+        inst.push_back(instanceFromClient(c));
+
+    return inst;
+}
+
+// rectangles of the mapped clients on the workspaces the monitors currently show (special workspaces included)
+static void hyprlandSyncGeometry()
+{
+    JsonValue monitors = parseJson(hyprlandRequest("j/monitors"));
+    JsonValue clients = parseJson(hyprlandRequest("j/clients"));
+    std::vector<long long> shown = {};
+
+    for (const JsonValue& m : monitors.items)
+    {
+        shown.push_back(m["activeWorkspace"]["id"].asInt(0));
+        if (m.has("specialWorkspace")) shown.push_back(m["specialWorkspace"]["id"].asInt(0));
+    }
+
+    std::vector<WindowGeometry> windows = {};
+
+    for (const JsonValue& c : clients.items)
+    {
+        if (!c["mapped"].asBool(true) || c["hidden"].asBool()) continue;
+
+        long long ws = c["workspace"]["id"].asInt(0);
+        if (ws == 0 || std::find(shown.begin(), shown.end(), ws) == shown.end()) continue;
+
+        WindowGeometry g;
+        g.id = c["address"].asString();
+        g.monitorIdx = c["monitor"].asInt(0);
+        g.rect = { (int)c["at"][(size_t)0].asInt(), (int)c["at"][(size_t)1].asInt(), (int)c["size"][(size_t)0].asInt(), (int)c["size"][(size_t)1].asInt() };
+        windows.push_back(g);
+    }
+
+    windowGeometrySync(windows);
+}
+
+// events after which windows may have moved / appeared / disappeared on screen
+// (hyprland has no event for resizing or dragging floating windows, activewindowv2 at least catches focus changes after it)
+static bool hyprlandGeometryEvent(const std::string& line)
+{
+    static const std::vector<std::string> events = {
+        "openwindow", "closewindow", "movewindowv2", "workspacev2", "focusedmon", "moveworkspacev2",
+        "activespecial", "changefloatingmode", "fullscreen", "activewindowv2", "minimized", "monitoradded", "monitorremoved"
+    };
+
+    std::string ev = line.substr(0, line.find(">>"));
+    return std::find(events.begin(), events.end(), ev) != events.end();
+}
+
+/*
+    keeps the instance list up to date from events alone where possible:
+    the monitor of a window comes from the workspace it is on (workspace -> monitor map kept from workspace events),
+    j/clients is only fetched for addresses that aren't known yet (pid / fullscreen of new windows)
+*/
+struct HyprlandWatchState
+{
+    std::vector<AppInstance> instances = {};
+    std::unordered_map<std::string, std::string> windowWorkspace = {};     // address -> workspace name
+    std::unordered_map<std::string, int> workspaceMonitor = {};            // workspace name -> monitor id
+    std::unordered_map<std::string, int> monitorIds = {};                  // monitor name -> id
+    bool hasTitleV2 = false;
+
+    AppInstance * find(const std::string& id)
+    {
+        for (AppInstance& i : instances)
+        {
+            if (i.id == id) return &i;
+        }
+        return nullptr;
+    }
+
+    // full sync, once per connection
+    void load()
+    {
+        instances.clear();
+        windowWorkspace.clear();
+
+        for (const JsonValue& c : parseJson(hyprlandRequest("j/clients")).items)
+        {
+            instances.push_back(instanceFromClient(c));
+            windowWorkspace[instances.back().id] = c["workspace"]["name"].asString();
+        }
+
+        loadWorkspaces();
+    }
+
+    void loadWorkspaces()
+    {
+        workspaceMonitor.clear();
+        monitorIds.clear();
+
+        for (const JsonValue& w : parseJson(hyprlandRequest("j/workspaces")).items)
+            workspaceMonitor[w["name"].asString()] = w["monitorID"].asInt(0);
+
+        for (const JsonValue& m : parseJson(hyprlandRequest("j/monitors")).items)
+            monitorIds[m["name"].asString()] = m["id"].asInt(0);
+    }
+
+    // a workspace we haven't heard of (created on another connection / before createworkspace arrived) reloads the map once
+    int monitorOfWorkspace(const std::string& workspace)
+    {
+        auto it = workspaceMonitor.find(workspace);
+        if (it != workspaceMonitor.end()) return it->second;
+
+        loadWorkspaces();
+        it = workspaceMonitor.find(workspace);
+        return (it != workspaceMonitor.end()) ? it->second : 0;
+    }
+
+    // fields events don't carry (pid, fullscreen) of a window that just showed up
+    void fetch(const std::string& id)
+    {
+        for (const JsonValue& c : parseJson(hyprlandRequest("j/clients")).items)
+        {
+            if (c["address"].asString() != id) continue;
+
+            AppInstance * target = find(id);
+            if (target != nullptr) *target = instanceFromClient(c);
+            windowWorkspace[id] = c["workspace"]["name"].asString();
+            return;
+        }
+    }
+
+    // window moved to workspace, returns true if that changed its monitor
+    bool moveTo(const std::string& id, const std::string& workspace)
+    {
+        AppInstance * i = find(id);
+        if (i == nullptr) return false;
+
+        windowWorkspace[id] = workspace;
+        int monitor = monitorOfWorkspace(workspace);
+        if (i->monitorIdx == monitor) return false;
+
+        i->monitorIdx = monitor;
+        return true;
+    }
+
+    // workspace moved to another monitor, its windows go along
+    bool moveWorkspace(const std::string& workspace, const std::string& monitorName)
+    {
+        auto mon = monitorIds.find(monitorName);
+        if (mon == monitorIds.end())
+        {
+            loadWorkspaces();
+            mon = monitorIds.find(monitorName);
+            if (mon == monitorIds.end()) return false;
+        }
+
+        workspaceMonitor[workspace] = mon->second;
+        bool changed = false;
+
+        for (AppInstance& i : instances)
+        {
+            if (windowWorkspace[i.id] != workspace || i.monitorIdx == mon->second) continue;
+
+            i.monitorIdx = mon->second;
+            changed = true;
+        }
+
+        return changed;
+    }
+
+    // applies one "EVENT>>DATA" line, returns true if the instance list changed
+    bool apply(const std::string& line)
+    {
+        size_t sep = line.find(">>");
+        if (sep == std::string::npos) return false;
+
+        std::string ev = line.substr(0, sep);
+        std::string data = line.substr(sep + 2);
+
+        if (ev == "openwindow")
+        {
+            // ADDRESS,WORKSPACENAME,CLASS,TITLE
+            auto f = splitFields(data, 4);
+            std::string id = normalizeAddress(f[0]);
+            if (find(id) != nullptr) return false;
+
+            AppInstance i;
+            i.id = id;
+            i.wclass = f[2].empty() ? "-" : f[2];
+            i.title = f[3].empty() ? "-" : f[3];
+            i.monitorIdx = monitorOfWorkspace(f[1]);
+            instances.push_back(i);
+            windowWorkspace[id] = f[1];
+
+            // pid / fullscreen only exist in j/clients
+            fetch(id);
+            return true;
+        } else if (ev == "closewindow")
+        {
+            std::string id = normalizeAddress(data);
+            size_t before = instances.size();
+
+            instances.erase(std::remove_if(instances.begin(), instances.end(), [&id](const AppInstance& i) { return i.id == id; }), instances.end());
+            windowWorkspace.erase(id);
+            return instances.size() != before;
+        } else if (ev == "windowtitlev2")
+        {
+            // ADDRESS,TITLE
+            hasTitleV2 = true;
+            auto f = splitFields(data, 2);
+            AppInstance * i = find(normalizeAddress(f[0]));
+            std::string title = f[1].empty() ? "-" : f[1];
+
+            if (i == nullptr || i->title == title) return false;
+            i->title = title;
+            return true;
+        } else if (ev == "windowtitle")
+        {
+            // older hyprland only sends the address, newer ones follow up with windowtitlev2
+            // titles mostly change on the focused window, j/activewindow is one object instead of the whole client list
+            if (hasTitleV2) return false;
+
+            std::string id = normalizeAddress(data);
+            AppInstance * i = find(id);
+            if (i == nullptr) return false;
+
+            JsonValue active = parseJson(hyprlandRequest("j/activewindow"));
+            if (active["address"].asString() != id)
+            {
+                std::string before = i->title;
+                fetch(id);
+                return find(id)->title != before;
+            }
+
+            std::string title = active["title"].asString().empty() ? "-" : active["title"].asString();
+            if (i->title == title) return false;
+            i->title = title;
+            return true;
+        } else if (ev == "movewindow")
+        {
+            // ADDRESS,WORKSPACENAME, the workspace may live on another monitor
+            auto f = splitFields(data, 2);
+            return moveTo(normalizeAddress(f[0]), f[1]);
+        } else if (ev == "createworkspace" || ev == "destroyworkspace")
+        {
+            // WORKSPACENAME, created ones get looked up when a window lands on them
+            workspaceMonitor.erase(data);
+            return false;
+        } else if (ev == "moveworkspace")
+        {
+            // WORKSPACENAME,MONNAME
+            auto f = splitFields(data, 2);
+            return moveWorkspace(f[0], f[1]);
+        } else if (ev == "monitoradded" || ev == "monitorremoved")
+        {
+            // workspaces get moved around without moveworkspace events, monitor ids may change
+            loadWorkspaces();
+            bool changed = false;
+
+            for (AppInstance& i : instances)
+            {
+                int monitor = monitorOfWorkspace(windowWorkspace[i.id]);
+                changed |= i.monitorIdx != monitor;
+                i.monitorIdx = monitor;
+            }
+
+            return changed;
+        } else if (ev == "fullscreen")
+        {
+            // only tells 0/1 for the active window
+            JsonValue active = parseJson(hyprlandRequest("j/activewindow"));
+            AppInstance * i = find(active["address"].asString());
+            bool fullscreen = active["fullscreen"].asBool();
+
+            if (i == nullptr || i->fullscreen == fullscreen) return false;
+            i->fullscreen = fullscreen;
+            return true;
+        }
+
+        return false;
+    }
+};
+
+void hyprlandWatchInstances(std::atomic<bool>& running, const std::function<void(const std::vector<AppInstance>&)>& onChange)
+{
+    while (running)
+    {
+        int fd = connectUnixSocket(hyprlandSocketDir() + "/.socket2.sock");
+        if (fd < 0) return;
+
+        // full sync once per connection, afterwards only deltas
+        HyprlandWatchState state;
+        state.load();
+        onChange(state.instances);
+        bool geometrySynced = false;
+
+        std::string buffer;
+        char chunk[BUFSIZ];
+
+        while (running)
+        {
+            // intellihide may start wanting geometry after the connection was made (backends start before the window)
+            if (!geometrySynced && windowGeometryWanted())
+            {
+                hyprlandSyncGeometry();
+                geometrySynced = true;
+            }
+
+            pollfd pfd = { fd, POLLIN, 0 };
+            int r = poll(&pfd, 1, 500);
+
+            if (r < 0 && errno == EINTR) continue;
+            if (r < 0) break;
+            if (r == 0) continue;   // timeout, recheck running
+
+            ssize_t n = read(fd, chunk, sizeof(chunk));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+
+            buffer.append(chunk, n);
+
+            bool changed = false;
+            bool moved = false;
+            size_t start = 0;
+            size_t nl;
+
+            while ((nl = buffer.find('\n', start)) != std::string::npos)
+            {
+                std::string line = buffer.substr(start, nl - start);
+                changed |= state.apply(line);
+                moved |= hyprlandGeometryEvent(line);
+                start = nl + 1;
+            }
+
+            buffer.erase(0, start);
+
+            if (changed) onChange(state.instances);
+            // one resync per read, a burst of events (workspace switch) costs two requests
+            if (moved && windowGeometryWanted()) hyprlandSyncGeometry();
+        }
+
+        close(fd);
+
+        // socket closed (hyprland restarting?) give it a moment before reconnecting
+        if (running) std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+}
+
+/*
+    built in gtkdock_backend
+*/
+
+static std::atomic<bool> hyprlandWatching(false);
+
+static int hyprlandProbe()
+{
+    return hyprlandIpcAvailable();
+}
+
+static void hyprlandEnumerate(gtkdock_instances_cb cb, void * user_data)
+{
+    emitInstances(hyprlandGetClients(), cb, user_data);
+}
+
+static int hyprlandSubscribe(gtkdock_instances_cb cb, void * user_data)
+{
+    runWatcherThread(hyprlandWatching, hyprlandWatchInstances, hyprlandGetClients, cb, user_data);
+    return 0;
+}
+
+static void hyprlandUnsubscribe()
+{
+    hyprlandWatching = false;
+}
+
+static void hyprlandActivate(const char * id)
+{
+    hyprlandRequest(std::string("dispatch focuswindow address:") + id);
+}
+
+static void hyprlandClose(const char * const * ids, size_t count)
+{
+    std::vector<std::string> dispatches = {};
+    for (size_t i = 0; i < count; i++)
+        dispatches.push_back(std::string("dispatch closewindow address:") + ids[i]);
+
+    hyprlandBatch(dispatches);
+}
+
+static size_t hyprlandMenuActions(const gtkdock_instance *, gtkdock_menu_action * actions, size_t max)
+{
+    if (max < 1) return 0;
+
+    actions[0] = { "Toggle Floating", "togglefloating" };
+    return 1;
+}
+
+static void hyprlandRunMenuAction(const char * id, const char * action)
+{
+    hyprlandRequest(std::string("dispatch ") + action + " address:" + id);
+}
+
+static const gtkdock_backend hyprland = {
+    GTKDOCK_BACKEND_ABI_VERSION,
+    "hyprland",
+    hyprlandProbe,
+    hyprlandEnumerate,
+    hyprlandSubscribe,
+    hyprlandUnsubscribe,
+    hyprlandActivate,
+    hyprlandClose,
+    hyprlandMenuActions,
+    hyprlandRunMenuAction
+};
+
+const gtkdock_backend * hyprlandBackend()
+{
+    return &hyprland;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include "utils.h"
+#include "dock-backend.h"
+
+/*
+    in-process hyprland backend
+    talks directly to $XDG_RUNTIME_DIR/hypr/$HYPRLAND_INSTANCE_SIGNATURE/.socket.sock (requests)
+    and .socket2.sock (events) so no hyprctl / jq / bash processes get spawned
+*/
+
+// true if running under hyprland and the request socket exists
+bool hyprlandIpcAvailable();
+
+// sends request ex. "j/clients" or "dispatch focuswindow address:0x..." and returns the reply ("" on failure)
+std::string hyprlandRequest(const std::string& request);
+
+// sends multiple dispatches in one [[BATCH]] request
+std::string hyprlandBatch(const std::vector<std::string>& requests);
+
+// queries j/clients and converts them to AppInstances (id is the window address)
+std::vector<AppInstance> hyprlandGetClients();
+
+// blocks listening on .socket2.sock keeping an instance list that is updated incrementally
+// on openwindow/closewindow/windowtitle/fullscreen/movewindow/moveworkspace events
+// (monitors come from a workspace -> monitor map, j/clients only gets asked about new windows)
+// onChange gets called with the full list whenever it changed
+// also keeps window-geometry.h up to date while it is wanted (intellihide)
+// returns once running is false or the event socket can't be (re)connected
+void hyprlandWatchInstances(std::atomic<bool>& running, const std::function<void(const std::vector<AppInstance>&)>& onChange);
+
+// the above as a gtkdock_backend (see backend.h)
+const gtkdock_backend * hyprlandBackend();
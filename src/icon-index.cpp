@@ -0,0 +1,380 @@
+#include "icon-index.h"
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+static const char * const EXTENSIONS[] = { ".png", ".svg", ".xpm" };     // preference order of the spec
+
+enum class IconDirType { FIXED, SCALABLE, THRESHOLD };
+
+// one directory of a theme (ex. /usr/share/icons/hicolor/48x48/apps) with the sizes index.theme gives it
+struct IconDir
+{
+    std::string path = "";
+    int theme = 0;      // position in the inheritance chain, unthemed pixmaps come last
+    IconDirType type = IconDirType::THRESHOLD;
+    int size = 0;
+    int scale = 1;
+    int minSize = 0;
+    int maxSize = 0;
+    int threshold = 2;
+};
+
+// a file of an icon: the directory it is in and its extension, the path gets put together on lookup
+struct IconFile
+{
+    uint32_t dir = 0;
+    uint8_t ext = 0;
+};
+
+static std::mutex indexMutex;
+static std::string themeName = "hicolor";
+static bool built = false;
+static int defaultSize = 48;
+static int defaultScale = 1;
+
+static std::vector<IconDir> dirs = {};
+static std::unordered_map<std::string, std::vector<IconFile>> icons = {};
+// "name@size@scale" -> path, "" for misses
+static std::unordered_map<std::string, std::string> lookups = {};
+
+// directories whose mtime changes when icons get installed / removed
+static std::vector<std::pair<std::string, std::filesystem::file_time_type>> watched = {};
+
+static std::vector<std::string> iconBaseDirs()
+{
+    std::vector<std::string> bases = {};
+    const char * home = std::getenv("HOME");
+    const char * dataHome = std::getenv("XDG_DATA_HOME");
+    const char * dataDirs = std::getenv("XDG_DATA_DIRS");
+
+    if (home != NULL) bases.push_back(std::string(home) + "/.icons");
+
+    if (dataHome != NULL && dataHome[0] != '\0') bases.push_back(std::string(dataHome) + "/icons");
+    else if (home != NULL) bases.push_back(std::string(home) + "/.local/share/icons");
+
+    std::string dd = (dataDirs != NULL && dataDirs[0] != '\0') ? dataDirs : "/usr/local/share:/usr/share";
+    size_t start = 0;
+
+    while (start <= dd.size())
+    {
+        size_t end = dd.find(':', start);
+        if (end == std::string::npos) end = dd.size();
+        if (end > start) bases.push_back(dd.substr(start, end - start) + "/icons");
+        start = end + 1;
+    }
+
+    return bases;
+}
+
+static bool fileExists(const std::string& path)
+{
+    std::error_code ec;
+    return std::filesystem::exists(path, ec);
+}
+
+static std::string trimmed(const std::string& s)
+{
+    size_t b = s.find_first_not_of(" \t\r");
+    size_t e = s.find_last_not_of(" \t\r");
+    return (b == std::string::npos) ? "" : s.substr(b, e - b + 1);
+}
+
+static std::vector<std::string> splitList(const std::string& s)
+{
+    std::vector<std::string> items = {};
+    size_t start = 0;
+
+    while (start <= s.size())
+    {
+        size_t end = s.find(',', start);
+        if (end == std::string::npos) end = s.size();
+
+        std::string item = trimmed(s.substr(start, end - start));
+        if (!item.empty()) items.push_back(item);
+        start = end + 1;
+    }
+
+    return items;
+}
+
+// index.theme as section -> key -> value
+using ThemeFile = std::unordered_map<std::string, std::unordered_map<std::string, std::string>>;
+
+static ThemeFile parseThemeFile(const std::string& path)
+{
+    ThemeFile file;
+    std::ifstream in(path);
+    std::string line;
+    std::string section = "";
+
+    while (std::getline(in, line))
+    {
+        line = trimmed(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        if (line[0] == '[')
+        {
+            section = line.substr(1, line.find(']') - 1);
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq != std::string::npos) file[section][trimmed(line.substr(0, eq))] = trimmed(line.substr(eq + 1));
+    }
+
+    return file;
+}
+
+static int intValue(const std::unordered_map<std::string, std::string>& section, const std::string& key, int def)
+{
+    auto it = section.find(key);
+    if (it == section.end()) return def;
+    return std::atoi(it->second.c_str());
+}
+
+static void watch(const std::string& path)
+{
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (!ec) watched.push_back({ path, mtime });
+}
+
+// adds every icon file directly in dir.path
+static void scanDir(const IconDir& dir)
+{
+    std::error_code ec;
+    std::filesystem::directory_iterator it(dir.path, ec);
+    if (ec) return;
+
+    uint32_t idx = dirs.size();
+    dirs.push_back(dir);
+    watch(dir.path);
+
+    for (; it != std::filesystem::directory_iterator(); it.increment(ec))
+    {
+        if (ec) break;
+
+        std::string file = it->path().filename().string();
+        size_t dot = file.rfind('.');
+        if (dot == std::string::npos) continue;
+
+        std::string ext = file.substr(dot);
+
+        for (uint8_t e = 0; e < 3; e++)
+        {
+            if (ext == EXTENSIONS[e])
+            {
+                icons[file.substr(0, dot)].push_back({ idx, e });
+                break;
+            }
+        }
+    }
+}
+
+// walks theme and everything it inherits (depth first, each theme once), hicolor always comes last
+static void collectThemes(const std::string& theme, const std::vector<std::string>& bases, std::vector<std::string>& chain)
+{
+    if (theme == "hicolor" || std::find(chain.begin(), chain.end(), theme) != chain.end()) return;
+    chain.push_back(theme);
+
+    for (const std::string& base : bases)
+    {
+        std::string path = base + "/" + theme + "/index.theme";
+        if (!fileExists(path)) continue;
+
+        ThemeFile file = parseThemeFile(path);
+        for (const std::string& parent : splitList(file["Icon Theme"]["Inherits"]))
+            collectThemes(parent, bases, chain);
+        break;
+    }
+}
+
+static void build()
+{
+    dirs.clear();
+    icons.clear();
+    lookups.clear();
+    watched.clear();
+
+    std::vector<std::string> bases = iconBaseDirs();
+    std::vector<std::string> chain = {};
+
+    collectThemes(themeName, bases, chain);
+    chain.push_back("hicolor");
+
+    for (size_t t = 0; t < chain.size(); t++)
+    {
+        // the first index.theme found describes the theme, its directories get scanned in every base dir
+        ThemeFile file;
+        for (const std::string& base : bases)
+        {
+            std::string path = base + "/" + chain[t] + "/index.theme";
+            if (!fileExists(path)) continue;
+
+            file = parseThemeFile(path);
+            break;
+        }
+
+        std::vector<std::string> subdirs = splitList(file["Icon Theme"]["Directories"]);
+        for (const std::string& d : splitList(file["Icon Theme"]["ScaledDirectories"]))
+        {
+            if (std::find(subdirs.begin(), subdirs.end(), d) == subdirs.end()) subdirs.push_back(d);
+        }
+
+        for (const std::string& base : bases)
+        {
+            watch(base + "/" + chain[t]);
+
+            for (const std::string& sub : subdirs)
+            {
+                const auto& section = file[sub];
+
+                IconDir dir;
+                dir.path = base + "/" + chain[t] + "/" + sub;
+                dir.theme = t;
+                dir.size = intValue(section, "Size", 0);
+                dir.scale = intValue(section, "Scale", 1);
+                dir.minSize = intValue(section, "MinSize", dir.size);
+                dir.maxSize = intValue(section, "MaxSize", dir.size);
+                dir.threshold = intValue(section, "Threshold", 2);
+
+                auto type = section.find("Type");
+                if (type != section.end() && type->second == "Fixed") dir.type = IconDirType::FIXED;
+                else if (type != section.end() && type->second == "Scalable") dir.type = IconDirType::SCALABLE;
+
+                scanDir(dir);
+            }
+        }
+    }
+
+    // unthemed icons fit any size
+    IconDir pixmaps;
+    pixmaps.path = "/usr/share/pixmaps";
+    pixmaps.theme = chain.size();
+    pixmaps.type = IconDirType::SCALABLE;
+    pixmaps.minSize = 1;
+    pixmaps.maxSize = 1 << 16;
+    scanDir(pixmaps);
+
+    for (const std::string& base : bases)
+        watch(base);
+
+    built = true;
+}
+
+void iconIndexRecheck()
+{
+    std::lock_guard<std::mutex> lock(indexMutex);
+    if (!built) return;
+
+    for (const auto& [path, mtime] : watched)
+    {
+        std::error_code ec;
+        auto current = std::filesystem::last_write_time(path, ec);
+
+        if (ec || current != mtime)
+        {
+            build();
+            return;
+        }
+    }
+}
+
+// DirectoryMatchesSize / DirectorySizeDistance of the icon theme spec, 0 is an exact match
+static int sizeDistance(const IconDir& dir, int size, int scale)
+{
+    int want = size * scale;
+
+    if (dir.type == IconDirType::FIXED)
+        return (dir.scale == scale && dir.size == size) ? 0 : 1 + std::abs(dir.size * dir.scale - want);
+
+    int minSize = (dir.type == IconDirType::SCALABLE) ? dir.minSize : dir.size - dir.threshold;
+    int maxSize = (dir.type == IconDirType::SCALABLE) ? dir.maxSize : dir.size + dir.threshold;
+
+    if (dir.scale == scale && size >= minSize && size <= maxSize) return 0;
+    if (want < minSize * dir.scale) return 1 + minSize * dir.scale - want;
+    if (want > maxSize * dir.scale) return 1 + want - maxSize * dir.scale;
+    return 1;
+}
+
+static std::string lookupLocked(const std::string& name, int size, int scale)
+{
+    auto it = icons.find(name);
+    if (it == icons.end()) return "";
+
+    const IconFile * best = nullptr;
+    int bestTheme = 0;
+    int bestDistance = 0;
+
+    // files are in scan order: theme, directory, so the first theme that has the icon comes first
+    for (const IconFile& f : it->second)
+    {
+        const IconDir& dir = dirs[f.dir];
+        if (best != nullptr && dir.theme != bestTheme) break;
+
+        int distance = sizeDistance(dir, size, scale);
+
+        if (best == nullptr || distance < bestDistance || (distance == bestDistance && f.ext < best->ext))
+        {
+            best = &f;
+            bestTheme = dir.theme;
+            bestDistance = distance;
+        }
+    }
+
+    return dirs[best->dir].path + "/" + name + EXTENSIONS[best->ext];
+}
+
+void iconIndexSetTheme(const std::string& theme)
+{
+    std::lock_guard<std::mutex> lock(indexMutex);
+    if (theme.empty() || theme == themeName) return;
+
+    themeName = theme;
+    built = false;
+}
+
+void iconIndexSetSize(int size, int scale)
+{
+    std::lock_guard<std::mutex> lock(indexMutex);
+
+    defaultSize = std::max(size, 1);
+    defaultScale = std::max(scale, 1);
+}
+
+std::string iconIndexLookup(const std::string& iconName, int size, int scale)
+{
+    std::string name = iconName;
+
+    // some desktop files name the file instead of the icon
+    for (const char * ext : EXTENSIONS)
+    {
+        size_t len = std::char_traits<char>::length(ext);
+        if (name.size() > len && name.compare(name.size() - len, len, ext) == 0)
+        {
+            name.erase(name.size() - len);
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(indexMutex);
+
+    if (!built) build();
+
+    if (size <= 0) size = defaultSize;
+    if (scale <= 0) scale = defaultScale;
+
+    std::string key = name + "@" + std::to_string(size) + "@" + std::to_string(scale);
+    auto cached = lookups.find(key);
+    if (cached != lookups.end()) return cached->second;
+
+    std::string path = lookupLocked(name, size, scale);
+    lookups[key] = path;
+    return path;
+}
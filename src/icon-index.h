@@ -0,0 +1,28 @@
+#pragma once
+#include <string>
+
+/*
+    icon index: in-process icon theme lookup behind findIconPath(), no plocate / GTK / probing of hard coded directories
+    built once from the index.theme of the active theme and the themes it inherits, then hicolor and unthemed pixmaps
+    ($HOME/.icons, $XDG_DATA_HOME/icons, $XDG_DATA_DIRS/icons, /usr/share/pixmaps)
+    every icon name maps to the files it has in the theme directories, a lookup picks the best size of the first theme
+    that has it (icon theme spec order), results and misses are cached
+
+    refresh: iconIndexRecheck() compares the mtimes of the scanned directories (like GTK does) and rebuilds if icons
+    got installed / removed, the entry pipeline calls it when its desktop file watcher fires (apps bring their icons along)
+    iconIndexSetTheme() rebuilds for another theme on the next lookup
+    safe to use from any thread
+*/
+
+// active icon theme (gtk-icon-theme-name), "hicolor" until set
+void iconIndexSetTheme(const std::string& theme);
+
+// rebuilds the index if a theme directory changed since it was built
+void iconIndexRecheck();
+
+// size px / scale factor lookups without an explicit size use, the dock sets the size it draws icons at (48@1 until set)
+void iconIndexSetSize(int size, int scale);
+
+// path of the best file for iconName (with or without .png / .svg / .xpm) at size px and scale, "" if no theme has it
+// size / scale 0: the ones given to iconIndexSetSize()
+std::string iconIndexLookup(const std::string& iconName, int size = 0, int scale = 0);
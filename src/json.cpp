@@ -0,0 +1,291 @@
+#include "json.h"
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+
+static const JsonValue nullValue = {};
+
+const JsonValue& JsonValue::operator[](const std::string& key) const
+{
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (keys[i] == key)
+            return items[i];
+    }
+
+    return nullValue;
+}
+
+const JsonValue& JsonValue::operator[](size_t idx) const
+{
+    if (idx < items.size())
+        return items[idx];
+
+    return nullValue;
+}
+
+bool JsonValue::has(const std::string& key) const
+{
+    for (const std::string& k : keys)
+    {
+        if (k == key)
+            return true;
+    }
+
+    return false;
+}
+
+std::string JsonValue::asString(const std::string& def) const
+{
+    return (type == Type::String) ? str : def;
+}
+
+long long JsonValue::asInt(long long def) const
+{
+    if (type == Type::Number) return (long long)number;
+    if (type == Type::Bool) return boolean ? 1 : 0;
+    return def;
+}
+
+bool JsonValue::asBool(bool def) const
+{
+    if (type == Type::Bool) return boolean;
+    if (type == Type::Number) return number != 0;
+    return def;
+}
+
+struct JsonParser
+{
+    const std::string& text;
+    size_t pos = 0;
+    bool failed = false;
+
+    void skipWhitespace()
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+            pos++;
+    }
+
+    bool consume(char c)
+    {
+        skipWhitespace();
+        if (pos < text.size() && text[pos] == c)
+        {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool consumeWord(const char * word)
+    {
+        size_t len = std::char_traits<char>::length(word);
+        if (text.compare(pos, len, word) == 0)
+        {
+            pos += len;
+            return true;
+        }
+        failed = true;
+        return false;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t cp)
+    {
+        if (cp < 0x80)
+        {
+            out += (char)cp;
+        } else if (cp < 0x800)
+        {
+            out += (char)(0xC0 | (cp >> 6));
+            out += (char)(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000)
+        {
+            out += (char)(0xE0 | (cp >> 12));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        } else
+        {
+            out += (char)(0xF0 | (cp >> 18));
+            out += (char)(0x80 | ((cp >> 12) & 0x3F));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        }
+    }
+
+    uint32_t parseHex4()
+    {
+        if (pos + 4 > text.size())
+        {
+            failed = true;
+            return 0;
+        }
+
+        uint32_t v = std::strtoul(text.substr(pos, 4).c_str(), nullptr, 16);
+        pos += 4;
+        return v;
+    }
+
+    std::string parseString()
+    {
+        std::string out;
+        pos++; // opening quote
+
+        while (pos < text.size())
+        {
+            char c = text[pos++];
+
+            if (c == '"') return out;
+
+            if (c != '\\')
+            {
+                out += c;
+                continue;
+            }
+
+            if (pos >= text.size()) break;
+
+            char e = text[pos++];
+            switch (e)
+            {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u':
+                {
+                    uint32_t cp = parseHex4();
+                    // surrogate pair
+                    if (cp >= 0xD800 && cp <= 0xDBFF && text.compare(pos, 2, "\\u") == 0)
+                    {
+                        pos += 2;
+                        uint32_t low = parseHex4();
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, cp);
+                    break;
+                }
+                default: out += e; break;
+            }
+        }
+
+        failed = true;
+        return out;
+    }
+
+    JsonValue parseValue(int depth)
+    {
+        JsonValue v;
+        skipWhitespace();
+
+        if (pos >= text.size() || depth > 256)
+        {
+            failed = true;
+            return v;
+        }
+
+        char c = text[pos];
+
+        if (c == '{')
+        {
+            v.type = JsonValue::Type::Object;
+            pos++;
+            if (consume('}')) return v;
+
+            do
+            {
+                skipWhitespace();
+                if (pos >= text.size() || text[pos] != '"')
+                {
+                    failed = true;
+                    return v;
+                }
+
+                v.keys.push_back(parseString());
+
+                if (!consume(':'))
+                {
+                    failed = true;
+                    return v;
+                }
+
+                v.items.push_back(parseValue(depth + 1));
+                if (failed) return v;
+            } while (consume(','));
+
+            if (!consume('}')) failed = true;
+        } else if (c == '[')
+        {
+            v.type = JsonValue::Type::Array;
+            pos++;
+            if (consume(']')) return v;
+
+            do
+            {
+                v.items.push_back(parseValue(depth + 1));
+                if (failed) return v;
+            } while (consume(','));
+
+            if (!consume(']')) failed = true;
+        } else if (c == '"')
+        {
+            v.type = JsonValue::Type::String;
+            v.str = parseString();
+        } else if (c == 't')
+        {
+            v.type = JsonValue::Type::Bool;
+            v.boolean = consumeWord("true");
+        } else if (c == 'f')
+        {
+            v.type = JsonValue::Type::Bool;
+            consumeWord("false");
+        } else if (c == 'n')
+        {
+            consumeWord("null");
+        } else
+        {
+            const char * start = text.c_str() + pos;
+            char * end = nullptr;
+            v.type = JsonValue::Type::Number;
+            v.number = std::strtod(start, &end);
+
+            if (end == start) failed = true;
+            pos += end - start;
+        }
+
+        return v;
+    }
+};
+
+JsonValue parseJson(const std::string& text)
+{
+    JsonParser p = { text };
+    JsonValue v = p.parseValue(0);
+
+    if (p.failed) return JsonValue();
+    return v;
+}
+
+std::string escapeJsonString(const std::string& str)
+{
+    std::string out;
+    out.reserve(str.size());
+
+    for (unsigned char c : str)
+    {
+        if (c == '"') out += "\\\"";
+        else if (c == '\\') out += "\\\\";
+        else if (c == '\n') out += "\\n";
+        else if (c == '\t') out += "\\t";
+        else if (c == '\r') out += "\\r";
+        else if (c < 0x20)
+        {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        }
+        else out += c;
+    }
+
+    return out;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/*
+    JsonValue: minimal json reader for compositor ipc replies (hyprland, sway ...)
+    objects keep their keys in order, missing keys / wrong types return a null value instead of throwing
+*/
+
+struct JsonValue
+{
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0;
+    std::string str = "";
+    std::vector<JsonValue> items = {};
+    std::vector<std::string> keys = {};
+
+    // object member access (returns null value if key doesn't exist)
+    const JsonValue& operator[](const std::string& key) const;
+
+    // array element access (returns null value if out of range)
+    const JsonValue& operator[](size_t idx) const;
+
+    bool has(const std::string& key) const;
+    bool isNull() const { return type == Type::Null; }
+    size_t size() const { return items.size(); }
+
+    std::string asString(const std::string& def = "") const;
+    long long asInt(long long def = 0) const;
+    bool asBool(bool def = false) const;
+};
+
+// parses text into a JsonValue, returns null value on malformed input
+JsonValue parseJson(const std::string& text);
+
+// escapes str so it can be put between quotes in a json document
+std::string escapeJsonString(const std::string& str);
@@ -7,6 +7,7 @@
 #include <map>
 #include <set>
 #include <limits>
+#include <cmath>
 #include <algorithm>
 #include <fstream>
 #include <array>
@@ -18,17 +19,23 @@
 #include <gtkmm-4.0/gtkmm.h>
 #include "utils.h"
 #include "wm-specific.h"
+#include "backend.h"
+#include "script-stream.h"
+#include "entry-pipeline.h"
+#include "dock-view.h"
+#include "animation.h"
+#include "window-geometry.h"
+#include "icon-index.h"
+#include "poll-scheduler.h"
+#include "x11-ewmh.h"
 
 /*
     wayland: bool checking if XDG_SESSION_TYPE is wayland
-    current_instances: list off all instances i. e. wm managed windows / programs returned by list_windows.bash
     running: for second thread that updates dock entries that tracks running status
     DesktopFiles: list of all Apps on System (.desktop Files)
 */
 
-std::vector<AppInstance> current_instances = {};
 std::atomic<bool> running(true);
-std::mutex instances_mutex;
 std::vector<DesktopEntry> DesktopFiles = {};
 
 
@@ -47,9 +54,11 @@ void chdir_to_parentpath()
 
 void check_wayland_support()
 {
-    if (!(strcmp(std::getenv("XDG_SESSION_TYPE"), "wayland") == 0))
+    const char * session = std::getenv("XDG_SESSION_TYPE");
+
+    if (!(session != NULL && strcmp(session, "wayland") == 0) && !x11EwmhAvailable())
     {
-        std::cout << "\nThis Application only supports wayland" << std::endl;
+        std::cout << "\nThis Application only supports wayland and X11 with an EWMH compliant window manager" << std::endl;
         std::exit(0);    
     }
 }
@@ -69,35 +78,21 @@ void check_conf_dir()
 }
 
 /*
-    getEntries returns a vector of all wm managed applications each entry has a vector instances(windows) that share the same class
-    instances vector gets used to find desktop file which then fills out the rest of the AppEntry struct using parseDesktopFile()
-    icon getss found using gtk in findIconPath()
+    InstanceObject: one window in the window list of an app menu (Gio::ListStore item)
 */
 
-std::vector<AppEntry> getEntries(bool isolated, int monIdx)
+class InstanceObject : public Glib::Object
 {
-    std::lock_guard<std::mutex> lock(instances_mutex);
-    std::vector<AppEntry> res = {};
-    bool singleInstance = getIfThisIsOnlyInstance();
-    // (class, entry)
-    std::unordered_map<std::string, AppEntry> entries = {};
-    if (current_instances.size() == 0) current_instances = getRunningInstances();
-
-    for (AppInstance& inst : current_instances)
-    {
-        if (singleInstance || (inst.monitorIdx == monIdx))
-            entries[inst.wclass].instances.push_back(inst);
-    }
-
-    for (auto& pair : entries)
-    {
-        pair.second.count_instances = pair.second.instances.size();
-        pair.second.app = getEntryOfInstances(pair.second.instances, DesktopFiles);
-        res.push_back(pair.second);
-    }
+    public:
+        AppInstance inst;
 
-    return res;
-}
+        static Glib::RefPtr<InstanceObject> create(const AppInstance& inst)
+        {
+            auto obj = Glib::make_refptr_for_instance<InstanceObject>(new InstanceObject());
+            obj->inst = inst;
+            return obj;
+        }
+};
 
 /*
     Win: is the Dock Window class
@@ -133,13 +128,31 @@ class Win : public Gtk::Window
             int offset_height = 0;
             bool set_height = false;
             bool set_width = false;
+            int poll_interval_min = 250;
+            int poll_interval_max = 4000;
+            int coalesce_window = 30;
+            EntryOrder entry_order = EntryOrder::FIRST_SEEN;
+            double magnification = 1;
+            bool merged_hotspot = false;
+            bool intellihide = false;
+            int scale = 1;      // scale factor icon paths got resolved for
         } appCtx;
 
         // State Machine for animating the Dock to reduce buggy behaviour
         enum class DockState { Hidden, Visible, Hiding, Showing};
         DockState state = DockState::Visible;
         DockState wanted_state = DockState::Hidden;
-        int64_t timeWhenMouseLeftDock = 0;
+        sigc::connection autohideTimer;
+        bool pointerInside = false;
+
+        // slide: 0 shown .. 1 hidden, only runs frame callbacks while it moves
+        Tween slide;
+        Animator animator{*this};
+
+        // change coalescing: at most one updateDock() per frame, only one pending auto hide timer
+        bool updateQueued = false;
+        sigc::connection hideTimer;
+        uint64_t dockUpdates = 0;
 
 
         Win(int argc, char **argv)
@@ -185,10 +198,33 @@ class Win : public Gtk::Window
                         } else if (values[0] == "isolated_to_monitor")
                         {
                             appCtx.isolated_to_monitor = (bool)std::stoi(values[1]);
+                        } else if (values[0] == "poll_interval_min")
+                        {
+                            appCtx.poll_interval_min = std::stoi(values[1]);
+                        } else if (values[0] == "poll_interval_max")
+                        {
+                            appCtx.poll_interval_max = std::stoi(values[1]);
+                        } else if (values[0] == "coalesce_window")
+                        {
+                            appCtx.coalesce_window = std::stoi(values[1]);
+                        } else if (values[0] == "intellihide")
+                        {
+                            // hiding only happens with auto hide, exclusive_mode still turns both off
+                            appCtx.intellihide = (bool)std::stoi(values[1]);
+                            if (appCtx.intellihide) appCtx.autohide = true;
+                        } else if (values[0] == "merged_hotspot")
+                        {
+                            appCtx.merged_hotspot = (bool)std::stoi(values[1]);
+                        } else if (values[0] == "magnification")
+                        {
+                            appCtx.magnification = std::stod(values[1]);
+                        } else if (values[0] == "entry_order")
+                        {
+                            appCtx.entry_order = (values[1] == "name") ? EntryOrder::NAME : EntryOrder::FIRST_SEEN;
                         } else if (values[0] == "exclusive_mode")
                         {
                             appCtx.exclusiveMode = (bool)std::stoi(values[1]);
-                            if (appCtx.exclusiveMode) appCtx.autohide = false;
+                            if (appCtx.exclusiveMode) appCtx.autohide = appCtx.intellihide = false;
                         }
                         else if (values[0] == "hotfix_height")
                         {
@@ -223,8 +259,10 @@ class Win : public Gtk::Window
 
                 conf.close();
 
+                pollSchedulerConfigure(appCtx.poll_interval_min, appCtx.poll_interval_max);
+
                 appCtx.icon_bg_size = appCtx.icon_size * (4.f/3.f);
-                appCtx.winH = appCtx.icon_bg_size + 2 * appCtx.padding;
+                appCtx.winH = appCtx.icon_bg_size + 2 * appCtx.padding + magnifyRoom();
                 appCtx.dockH = appCtx.icon_bg_size;
 
                 for (int i = 0; i < argc; i++)
@@ -269,20 +307,35 @@ class Win : public Gtk::Window
                     }
                 }
                 
-                appCtx.entries = loadEntries();
-                appCtx.dockW = (appCtx.entries.size()) * (appCtx.icon_bg_size + appCtx.padding);
-                
-                bool sep = false;
-                for (AppEntry& e : appCtx.entries)
-                {
-                    if (e.app.name == "line")
-                    {
-                        sep = true;
-                        break;
-                    }
-                }
+                // desktop files name their icons, they get resolved at the size the dock draws them (magnified, device pixels)
+                appCtx.scale = monitorScale();
+                iconIndexSetSize(iconLookupSize(), appCtx.scale);
+                DesktopFiles = findDesktopFiles();
+
+                // moving to a monitor with another scale: parse them again for the sharper / smaller files
+                property_scale_factor().signal_changed().connect([this]() {
+                    if (appCtx.scale == get_scale_factor()) return;
+
+                    appCtx.scale = get_scale_factor();
+                    iconIndexSetSize(iconLookupSize(), appCtx.scale);
+                    rescanDesktopFiles();
+                });
 
-                if (sep) appCtx.dockW -= appCtx.icon_bg_size + appCtx.padding - 6;
+                // entries get resolved on a worker, updateDock() runs whenever it published a changed snapshot
+                EntryPipelineConfig pipeline;
+                pipeline.isolated = appCtx.isolated_to_monitor;
+                pipeline.monitorIdx = appCtx.displayIdx;
+                pipeline.drawLauncher = appCtx.drawLauncher;
+                pipeline.launcherCmd = appCtx.launcher_cmd;
+                pipeline.desktopFiles = DesktopFiles;
+                pipeline.coalesceMs = appCtx.coalesce_window;
+                pipeline.order = appCtx.entry_order;
+
+                startEntryPipeline(pipeline, [this]() { queueUpdateDock(); });
+
+                appCtx.entries = *currentEntries();
+                // along the edge, gets swapped below for left / right docks
+                appCtx.dockW = dockLength();
 
                 appCtx.winW = appCtx.dockW + appCtx.padding;
 
@@ -329,166 +382,127 @@ class Win : public Gtk::Window
 
             set_decorated(false);
             set_opacity(1.0);
+            add_css_class("dockwin");
 
             // populate Dock with widgets
             buildDock();
 
+            signal_map().connect([this]() {
+                if (shapesInput()) applyInputRegion();
+            });
+
             // logic for auto hide functionality
             auto motion_controllerWin = Gtk::EventControllerMotion::create();
 
-            motion_controllerWin->signal_enter().connect([this](double x, double y) mutable {
-                if (this->state == Win::DockState::Hiding || this->wanted_state == Win::DockState::Hidden)
-                {
-                    this->wanted_state = Win::DockState::Visible;
-                }
+            motion_controllerWin->signal_enter().connect([this](double x, double y) {
+                this->pointerInside = true;
+
+                // merged_hotspot: this is the hotspot, the dock is about to be shown
+                if (this->state == Win::DockState::Hidden) pollSchedulerKick();
+
+                this->setWantedState(Win::DockState::Visible);
             });
 
-            motion_controllerWin->signal_leave().connect([this]() mutable {
+            motion_controllerWin->signal_leave().connect([this]() {
+                this->pointerInside = false;
+
                 if (this->state == Win::DockState::Visible || this->state == Win::DockState::Showing)
-                {
-                    this->timeWhenMouseLeftDock = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
-                    this->wanted_state = Win::DockState::Hidden;
-                }
+                    this->setWantedState(Win::DockState::Hidden);
             });
 
-            if (appCtx.autohide)
-            {
-                add_tick_callback([this, last_time = int64_t{0}](const Glib::RefPtr<Gdk::FrameClock>& clock) mutable {
-                    double frame_time_ms = 0;
+            add_controller(motion_controllerWin);
 
-                    {
-                        int64_t current_time = clock->get_frame_time();  // microseconds
+            // hides once the timeout passed without the pointer on it
+            if (appCtx.autohide && !appCtx.intellihide) setWantedState(Win::DockState::Hidden);
 
-                        if (last_time != 0) {
-                            int64_t delta_us = current_time - last_time;
-                            frame_time_ms = delta_us / 1000.0;
-                        }
+            // intellihide: the backend's first geometry report decides, backends without geometry fall back to plain auto hide
+            if (appCtx.intellihide)
+            {
+                windowGeometryWatch([this]() { checkIntellihide(); });
 
-                        last_time = current_time;
-                    }
-                    
-                    if (wanted_state == Win::DockState::Hidden && (state == Win::DockState::Visible || state == Win::DockState::Showing))
-                    {
-                        if (std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count() - this->timeWhenMouseLeftDock > this->appCtx.timeout)
-                        {
-                            this->state = Win::DockState::Hiding;
-                        }
-                    }
+                Glib::signal_timeout().connect_once([this]() {
+                    if (!windowGeometryAvailable()) setWantedState(Win::DockState::Hidden);
+                }, 1000);
+            }
 
-                    if (wanted_state == Win::DockState::Visible && (state == Win::DockState::Hiding || state == Win::DockState::Hidden))
-                    {
-                        this->state = Win::DockState::Showing;
-                    }
+            // GTKDOCK_STATS=1 prints how many window changes ended up as dock rebuilds
+            if (std::getenv("GTKDOCK_STATS") != NULL)
+            {
+                Glib::signal_timeout().connect_seconds([this]() {
+                    EntryPipelineStats s = entryPipelineStats();
+                    std::cout << "changes received: " << s.instancesReceived << " entry builds: " << s.entriesBuilt
+                        << " snapshots published: " << s.snapshotsPublished << " dock updates: " << dockUpdates << " dock layouts: " << dock_view->layouts << " animation frames: " << animator.frames << std::endl;
+                    return true;
+                }, 10);
+            }
+        }
 
-                    if (state == Win::DockState::Hiding)
-                    {   
-                        if (!animateOut( frame_time_ms / appCtx.duration )) this->state = Win::DockState::Hidden;
-                    }
+        /*
+            queueUpdateDock: runs updateDock() once on the next frame clock tick no matter how many snapshots got published until then
+        */
 
-                    if (state == Win::DockState::Showing)
-                    {   
-                        if (!animateIn( frame_time_ms / appCtx.duration )) this->state = Win::DockState::Visible;
-                    }
+        void queueUpdateDock()
+        {
+            if (updateQueued) return;
 
-                    appCtx.winW = this->get_size(Gtk::Orientation::HORIZONTAL);
-                    appCtx.winH = this->get_size(Gtk::Orientation::VERTICAL);
-                    return true;
-                });
+            // unmapped windows get no frame ticks
+            if (!get_mapped())
+            {
+                updateDock();
+                return;
             }
-            add_controller(motion_controllerWin);
 
-            // relying on polling because i havent found a wm agnostic way to poll fow window client changes
-            Glib::signal_timeout().connect([this]() {
+            updateQueued = true;
+            add_tick_callback([this](const Glib::RefPtr<Gdk::FrameClock>&) {
+                updateQueued = false;
                 updateDock();
-                return true;
-            }, 500);
+                return false;
+            });
         }
 
         /*
-            updates Dock by checking if AppEntry vector has changed then rebuilding the Dock
+            updates Dock by diffing the new snapshot against the shown entries, only changed dock items get touched
         */
 
         void updateDock() {
-            auto newEntries = loadEntries();
+            EntrySnapshot snapshot = currentEntries();
+            const std::vector<AppEntry>& newEntries = *snapshot;
             
             // Check if entries changed
-            if (newEntries.size() != appCtx.entries.size() || 
-                !std::equal(newEntries.begin(), newEntries.end(), appCtx.entries.begin(),
-                    [](const AppEntry& a, const AppEntry& b)
-                    {
-                        if (a.count_instances != b.count_instances || a.app.name != b.app.name )
-                        {    
-                            return false;
-                        }
+            EntryDiff diff = diffEntries(appCtx.entries, newEntries);
 
-                        for (int i = 0; i < a.count_instances; i++)
-                        {
-                            if (a.instances[i].title != b.instances[i].title || a.instances[i].fullscreen != b.instances[i].fullscreen)
-                            {
-                                return false;
-                            }
-                        }
-
-                        return true;
-                    }
-            ))
+            if (!diff.empty())
             {
-                if (newEntries.size() != appCtx.entries.size()) wanted_state = Win::DockState::Visible;
-                cleanupDock();
+                if (!diff.added.empty() || !diff.removed.empty()) setWantedState(Win::DockState::Visible);
+                dockUpdates++;
 
                 appCtx.entries = newEntries;
 
+                if (appCtx.edge == DockEdge::EDGELEFT || appCtx.edge == DockEdge::EDGERIGHT)
+                    appCtx.dockH = dockLength();
+                else
+                    appCtx.dockW = dockLength();
+
+                // exclusive mode windows span the whole edge already
                 if (!appCtx.exclusiveMode)
                 {
                     if (appCtx.edge == DockEdge::EDGELEFT || appCtx.edge == DockEdge::EDGERIGHT)
-                    {
-                        appCtx.dockH = (appCtx.entries.size()) * (appCtx.icon_bg_size + appCtx.padding);
-                        
-                        bool sep = false;
-                        for (AppEntry& e : appCtx.entries)
-                        {
-                            if (e.app.name == "line")
-                            {
-                                sep = true;
-                                break;
-                            }
-                        }
-
-                        if (sep) appCtx.dockH -= appCtx.icon_bg_size + appCtx.padding - 6;
-
                         appCtx.winH = appCtx.dockH + appCtx.padding;
-                    }
                     else
-                    {
-                        appCtx.dockW = (appCtx.entries.size()) * (appCtx.icon_bg_size + appCtx.padding);
-                        
-                        bool sep = false;
-                        for (AppEntry& e : appCtx.entries)
-                        {
-                            if (e.app.name == "line")
-                            {
-                                sep = true;
-                                break;
-                            }
-                        }
-
-                        if (sep) appCtx.dockW -= appCtx.icon_bg_size + appCtx.padding - 6;
-
                         appCtx.winW = appCtx.dockW + appCtx.padding;
-                    }
 
                     this->set_default_size(appCtx.winW, appCtx.winH);
                 }
 
-                buildDock();
+                buildDock(diff);
 
                 if (!appCtx.exclusiveMode)
                 {
-                    Glib::signal_timeout().connect([this]() {
+                    hideTimer.disconnect();
+                    hideTimer = Glib::signal_timeout().connect([this]() {
                         if (state == Win::DockState::Visible)
                         {
-                            timeWhenMouseLeftDock = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
-                            wanted_state = Win::DockState::Hidden;
+                            setWantedState(Win::DockState::Hidden);
                             return false;
                         }
                         
@@ -498,372 +512,516 @@ class Win : public Gtk::Window
 
                 appCtx.winW = this->get_size(Gtk::Orientation::HORIZONTAL);
                 appCtx.winH = this->get_size(Gtk::Orientation::VERTICAL);
+
+                // the input region follows the new size
+                if (shapesInput()) applyInputRegion();
+
+                // so does the area windows have to stay out of
+                checkIntellihide();
             }
         }
 
-        // builds the Dock
-        void buildDock()
+        /*
+            the dock itself is one DockView (see dock-view.h) inside container, it draws the entries and reports clicks on them
+            dockItems holds everything else that belongs to an entry key: its menu, built on the first right click
+            and kept until something shown in it changes
+
+            the dock never grows past the monitor (dockLength()), the entries that don't fit are reached by scrolling the view
+        */
+        struct DockItem
         {
-            container = Gtk::make_managed<Gtk::Fixed>();
-            dock_box = Gtk::make_managed<Gtk::Fixed>();
+            AppEntry entry;
+            Gtk::Popover * menu = nullptr;
+            // windows listed in the menu, rows only exist for the visible ones
+            Glib::RefPtr<Gio::ListStore<InstanceObject>> instanceStore;
+            Gtk::SearchEntry * instanceSearch = nullptr;
+        };
 
-            container->get_style_context()->add_class("container");
-            dock_box->get_style_context()->add_class("dock");
-            
-            
-            if (appCtx.edge == DockEdge::EDGELEFT || appCtx.edge == DockEdge::EDGERIGHT)
+        std::unordered_map<std::string, std::unique_ptr<DockItem>> dockItems = {};
+
+        // window lists scroll past this height, the title filter shows up from this many windows on
+        static const int INSTANCE_LIST_MAX_HEIGHT = 320;
+        static const int INSTANCE_SEARCH_MIN = 8;
+
+        // builds the Dock, diff: what changed since the entries it was built from last (window lists get updated by it)
+        void buildDock(const EntryDiff& diff = {})
+        {
+            if (container == nullptr)
             {
-                double sx = 0;
-                double sy = 0;
-                double sl = appCtx.icon_bg_size;
-                
-                auto settings = Gtk::Settings::get_default();
-                
-                // Add N buttons with padding
-                for (int i = 0; i < appCtx.entries.size(); ++i) {
-                    float ssx = sx + (sl - appCtx.icon_size) * 0.5;
-                    float ssy = sy + (sl - appCtx.icon_size) * 0.5;
+                container = Gtk::make_managed<Gtk::Fixed>();
+                dock_view = Gtk::make_managed<DockView>();
+
+                container->get_style_context()->add_class("container");
+                dock_view->get_style_context()->add_class("dock");
+
+                dock_view->configure(appCtx.edge == DockEdge::EDGELEFT || appCtx.edge == DockEdge::EDGERIGHT, appCtx.icon_size, appCtx.icon_bg_size, appCtx.padding);
+                dock_view->setMagnification(appCtx.magnification,
+                    (appCtx.edge == DockEdge::EDGELEFT) ? Gtk::PositionType::LEFT : (appCtx.edge == DockEdge::EDGETOP) ? Gtk::PositionType::TOP :
+                    (appCtx.edge == DockEdge::EDGERIGHT) ? Gtk::PositionType::RIGHT : Gtk::PositionType::BOTTOM);
+                dock_view->onActivate = [this](const std::string& key, guint button) {
+                    activateItem(key, button);
+                };
+
+                container->put(*dock_view, 0, 0);
+                set_child(*container);
+            }
 
-                    if (appCtx.entries[i].app.name != "line")
-                    {
-                        auto btn = Gtk::make_managed<Gtk::MenuButton>();
-                        btn->set_size_request(sl, sl);
-                        btn->add_css_class("btn");
-                        btn->set_tooltip_text(appCtx.entries[i].app.name);
-                        
-                        auto pm = get_Menu(appCtx.entries[i]);
-                        
-                        pm->set_parent(*btn);
-                        pm->signal_realize().connect([pm, this]() {
-                            auto motion_controller = Gtk::EventControllerMotion::create();
+            reconcileDock(diff);
+            placeDockBox();
+        }
 
-                            motion_controller->signal_enter().connect([pm, this](double x, double y) {
-                                this->wanted_state = Win::DockState::Visible;                        
-                            });
+        // length of the dock along its edge: every entry, or as many whole entries as fit on the monitor
+        int dockLength()
+        {
+            bool vertical = appCtx.edge == DockEdge::EDGELEFT || appCtx.edge == DockEdge::EDGERIGHT;
+            double step = appCtx.icon_bg_size + appCtx.padding;
+            double length = 0;
 
-                            motion_controller->signal_leave().connect([pm, this]() {
-                                this->wanted_state = Win::DockState::Visible;               
-                            });
-                            
-                            pm->add_controller(motion_controller);
-                        });
+            for (const AppEntry& e : appCtx.entries)
+                length += (e.app.name == "line") ? 6 : step;
 
-                        auto click_gesture = Gtk::GestureClick::create();
-                        
-                        click_gesture->set_button(0);
-                        click_gesture->signal_released().connect([this, i, btn, click_gesture, pm](int n_press, double x, double y) {
-                            guint button = click_gesture->get_current_button();
-                            
-                            if (button == GDK_BUTTON_PRIMARY)
-                            {
-                                pm->popdown();
-                                if (this->appCtx.entries[i].count_instances == 0) std::system(("cd ~/  && " + this->appCtx.entries[i].app.execCmd + " &").c_str());
-                                else 
-                                {
-                                    openInstance(this->appCtx.entries[i].instances[0]);
-                                }
-                            } else if (button == GDK_BUTTON_SECONDARY && this->state == Win::DockState::Visible)
-                            {
-                                pm->popup(); // Show the dropdown
-                            }
-                        });
+            GdkMonitor * monitor = GDK_MONITOR((Gdk::Display::get_default()->get_monitors()->get_object(appCtx.displayIdx))->gobj());
+            GdkRectangle g;
+            gdk_monitor_get_geometry(monitor, &g);
 
-                        btn->add_controller(click_gesture);
-                        auto empty_box = Gtk::make_managed<Gtk::Box>();
-                        btn->set_child(*empty_box);  // No icon shown
+            double maxLength = (vertical ? g.height : g.width) - 2 * (appCtx.padding + appCtx.edgeMargin);
 
-                        add_widget_to_dock_box(*btn, sx, sy);
+            if (length <= maxLength) return length;
+            return std::floor(maxLength / step) * step;
+        }
 
-                        auto img = Gtk::make_managed<Gtk::Image>(appCtx.entries[i].app.iconPath);
-                        img->set_pixel_size(appCtx.icon_size);
-                        img->set_can_target(false);
+        // hands the entries to the view, drops the items of removed entries and updates the changed ones
+        void reconcileDock(const EntryDiff& diff)
+        {
+            std::set<std::string> keys = {};
+            std::vector<DockView::Item> items = {};
 
-                        add_widget_to_dock_box(*img, ssx, ssy);
-                        
-                        if (appCtx.entries[i].count_instances > 0)
-                        {
-                            auto dot_box = Gtk::make_managed<Gtk::DrawingArea>();
-                            dot_box->set_size_request(sl, appCtx.icon_size / 8.f - 2);
-                            dot_box->set_can_target(false);
-                            dot_box->set_content_width(sl);
-                            dot_box->set_content_height(appCtx.icon_size / 8.f - 2);
-                            dot_box->add_css_class("dotbox");
-
-                            dot_box->set_draw_func([this, i](const Cairo::RefPtr<Cairo::Context>& cr, int width, int height){
-                                cr->set_source_rgba(1.0, 1.0, 1.0, 1.0);
-
-                                if (this->appCtx.entries[i].count_instances == 1)
-                                {
-                                    cr->arc ( width / 2.0, height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                } else if (this->appCtx.entries[i].count_instances == 2)
-                                {
-                                    cr->arc ( width / 2.0 - (height / 2.0 + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 + (height / 2.0 + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                } else if (this->appCtx.entries[i].count_instances == 3)
-                                {
-                                    cr->arc ( width / 2.0, height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 - (height + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 + (height + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                } else
-                                {
-                                    cr->arc ( width / 2.0 - (height / 2.0 + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 + (height / 2.0 + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 - 1.5*(height + 2), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 + 1.5*(height + 2), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                }
+            for (const AppEntry& e : appCtx.entries)
+            {
+                keys.insert(e.key);
+                items.push_back({ e.key, e.app.name, e.app.iconPath, e.count_instances, e.app.name == "line" });
 
-                                cr->fill();
-                            });
+                auto it = dockItems.find(e.key);
 
-                            add_widget_to_dock_box(*dot_box, sx, sy + sl - appCtx.icon_size / 8.f + 1);
-                        }
-                        sy += sl + appCtx.padding;
-                    }
-                    else
-                    {
-                        auto sep = Gtk::make_managed<Gtk::Box>();
-                        sep->set_size_request(appCtx.dockW - 16, 1);
-                        sep->add_css_class("sep");
-                        add_widget_to_dock_box(*sep, sx + 8, sy);
-                        sy += 6;
-                    }
+                if (it == dockItems.end())
+                {
+                    auto item = std::make_unique<DockItem>();
+                    item->entry = e;
+                    dockItems.emplace(e.key, std::move(item));
+                } else if (it->second->entry.generation != e.generation)
+                {
+                    updateDockItem(*it->second, e, diff);
                 }
             }
-            else
+
+            for (auto it = dockItems.begin(); it != dockItems.end();)
             {
-                double sx = 0;
-                double sy = 0;
-                double sl = appCtx.icon_bg_size;
-                
-                auto settings = Gtk::Settings::get_default();
-                
-                // Add N buttons with padding
-                for (int i = 0; i < appCtx.entries.size(); ++i) {
-                    float ssx = sx + (sl - appCtx.icon_size) * 0.5;
-                    float ssy = sy + (sl - appCtx.icon_size) * 0.5;
+                if (keys.count(it->first) == 0)
+                {
+                    dropMenu(*it->second);
+                    it = dockItems.erase(it);
+                } else
+                {
+                    it++;
+                }
+            }
 
-                    if (appCtx.entries[i].app.name != "line")
-                    {
-                        auto btn = Gtk::make_managed<Gtk::MenuButton>();
-                        btn->set_size_request(sl, sl);
-                        btn->add_css_class("btn");
-                        btn->set_tooltip_text(appCtx.entries[i].app.name);
-                        
-                        auto pm = get_Menu(appCtx.entries[i]);
-                        
-                        pm->set_parent(*btn);
-                        pm->signal_realize().connect([pm, this]() {
-                            auto motion_controller = Gtk::EventControllerMotion::create();
+            bool vertical = appCtx.edge == DockEdge::EDGELEFT || appCtx.edge == DockEdge::EDGERIGHT;
+            dock_view->setVisibleLength(vertical ? appCtx.dockH : appCtx.dockW);
+            dock_view->setItems(items);
+        }
 
-                            motion_controller->signal_enter().connect([pm, this](double x, double y) {
-                                this->wanted_state = Win::DockState::Visible;                        
-                            });
+        // click on an entry of the view
+        void activateItem(const std::string& key, guint button)
+        {
+            auto it = dockItems.find(key);
+            if (it == dockItems.end()) return;
 
-                            motion_controller->signal_leave().connect([pm, this]() {
-                                this->wanted_state = Win::DockState::Visible;               
-                            });
-                            
-                            pm->add_controller(motion_controller);
-                        });
+            DockItem& item = *it->second;
 
-                        auto click_gesture = Gtk::GestureClick::create();
-                        
-                        click_gesture->set_button(0);
-                        click_gesture->signal_released().connect([this, i, btn, click_gesture, pm](int n_press, double x, double y) {
-                            guint button = click_gesture->get_current_button();
-                            
-                            if (button == GDK_BUTTON_PRIMARY)
-                            {
-                                pm->popdown();
-                                if (this->appCtx.entries[i].count_instances == 0) std::system(("cd ~/  && " + this->appCtx.entries[i].app.execCmd + " &").c_str());
-                                else 
-                                {
-                                    openInstance(this->appCtx.entries[i].instances[0]);
-                                }
-                            } else if (button == GDK_BUTTON_SECONDARY && this->state == Win::DockState::Visible)
-                            {
-                                pm->popup(); // Show the dropdown
-                            }
-                        });
+            // a hidden / sliding dock still gets pointer events (merged hotspot strip), nothing of it can be clicked
+            if (this->state != Win::DockState::Visible) return;
+
+            if (button == GDK_BUTTON_PRIMARY)
+            {
+                if (item.menu != nullptr) item.menu->popdown();
+                if (item.entry.count_instances == 0) std::system(("cd ~/  && " + item.entry.app.execCmd + " &").c_str());
+                else
+                {
+                    openInstance(item.entry.instances[0]);
+                }
+            } else if (button == GDK_BUTTON_SECONDARY)
+            {
+                ensureMenu(item);
+                item.menu->set_pointing_to(dock_view->itemRect(key));
+                item.menu->popup(); // Show the dropdown
+            }
+        }
 
-                        btn->add_controller(click_gesture);
-                        auto empty_box = Gtk::make_managed<Gtk::Box>();
-                        btn->set_child(*empty_box);  // No icon shown
+        // everything in the menu except the window list is the same, the list can be refreshed in place
+        static bool menuStillValid(const AppEntry& a, const AppEntry& b)
+        {
+            return a.isPinned == b.isPinned && a.app.name == b.app.name && a.app.execCmd == b.app.execCmd
+                && (a.count_instances > 0) == (b.count_instances > 0) && (a.count_instances > 1) == (b.count_instances > 1);
+        }
 
-                        add_widget_to_dock_box(*btn, sx, sy);
+        void updateDockItem(DockItem& item, const AppEntry& e, const EntryDiff& diff)
+        {
+            AppEntry old = item.entry;
+            item.entry = e;
 
-                        auto img = Gtk::make_managed<Gtk::Image>(appCtx.entries[i].app.iconPath);
-                        img->set_pixel_size(appCtx.icon_size);
-                        img->set_can_target(false);
+            // windows opening / closing / changing titles only touch the list model, the view rebinds the rows that changed
+            if (menuStillValid(old, e))
+            {
+                if (item.instanceStore) updateInstanceStore(item, diff);
+                return;
+            }
 
-                        add_widget_to_dock_box(*img, ssx, ssy);
-                        
-                        if (appCtx.entries[i].count_instances > 0)
-                        {
-                            auto dot_box = Gtk::make_managed<Gtk::DrawingArea>();
-                            dot_box->set_size_request(sl, appCtx.icon_size / 8.f - 2);
-                            dot_box->set_can_target(false);
-                            dot_box->set_content_width(sl);
-                            dot_box->set_content_height(appCtx.icon_size / 8.f - 2);
-                            dot_box->add_css_class("dotbox");
-
-                            dot_box->set_draw_func([this, i](const Cairo::RefPtr<Cairo::Context>& cr, int width, int height){
-                                cr->set_source_rgba(1.0, 1.0, 1.0, 1.0);
-
-                                if (this->appCtx.entries[i].count_instances == 1)
-                                {
-                                    cr->arc ( width / 2.0, height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                } else if (this->appCtx.entries[i].count_instances == 2)
-                                {
-                                    cr->arc ( width / 2.0 - (height / 2.0 + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 + (height / 2.0 + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                } else if (this->appCtx.entries[i].count_instances == 3)
-                                {
-                                    cr->arc ( width / 2.0, height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 - (height + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 + (height + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                } else
-                                {
-                                    cr->arc ( width / 2.0 - (height / 2.0 + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 + (height / 2.0 + 1), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 - 1.5*(height + 2), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                    cr->arc ( width / 2.0 + 1.5*(height + 2), height / 2.0,  height / 2.0,      0, 2 * G_PI);
-                                }
+            // gets rebuilt the next time somebody opens it
+            dropMenu(item);
+        }
 
-                                cr->fill();
-                            });
+        /*
+            applies the window changes of diff to the list by instance key: removed windows get removed, added ones inserted
+            where the entry has them, the rest keep their InstanceObject, only a changed title rebinds its row (to the same window)
+            so an open window popover keeps pointing at its window
+        */
+        void updateInstanceStore(DockItem& item, const EntryDiff& diff)
+        {
+            auto& store = item.instanceStore;
+            std::set<std::string> added = {};
 
-                            add_widget_to_dock_box(*dot_box, sx, sy + sl - appCtx.icon_size / 8.f + 1);
-                        }
-                        sx += sl + appCtx.padding;
-                    }
-                    else
-                    {
-                        auto sep = Gtk::make_managed<Gtk::Box>();
-                        sep->set_size_request(1, appCtx.dockH - 16);
-                        sep->add_css_class("sep");
-                        add_widget_to_dock_box(*sep, sx, sy + 8);
-                        sx += 6;
-                    }
+            for (const auto& [entryKey, key] : diff.instancesAdded)
+            {
+                if (entryKey == item.entry.key) added.insert(key);
+            }
+
+            for (const auto& [entryKey, key] : diff.instancesRemoved)
+            {
+                if (entryKey != item.entry.key) continue;
+
+                for (guint pos = 0; pos < store->get_n_items(); pos++)
+                {
+                    if (instanceKey(store->get_item(pos)->inst) != key) continue;
+
+                    store->remove(pos);
+                    break;
                 }
             }
-        
+
+            for (guint pos = 0; pos < item.entry.instances.size(); pos++)
+            {
+                const AppInstance& inst = item.entry.instances[pos];
+
+                if (added.count(instanceKey(inst)) != 0)
+                {
+                    store->insert(std::min(pos, store->get_n_items()), InstanceObject::create(inst));
+                    continue;
+                }
+
+                auto obj = (pos < store->get_n_items()) ? store->get_item(pos) : Glib::RefPtr<InstanceObject>();
+
+                // out of step with the entry (shouldn't happen), start over
+                if (!obj || instanceKey(obj->inst) != instanceKey(inst))
+                {
+                    fillInstanceStore(item);
+                    return;
+                }
+
+                bool retitled = obj->inst.title != inst.title;
+                obj->inst = inst;
+                if (retitled) store->splice(pos, 1, { obj });
+            }
+
+            if (store->get_n_items() != item.entry.instances.size())
+            {
+                fillInstanceStore(item);
+                return;
+            }
+
+            if (item.instanceSearch != nullptr) item.instanceSearch->set_visible(item.entry.count_instances >= INSTANCE_SEARCH_MIN);
+        }
+
+        void fillInstanceStore(DockItem& item)
+        {
+            std::vector<Glib::RefPtr<InstanceObject>> objs = {};
+            for (const AppInstance& inst : item.entry.instances)
+                objs.push_back(InstanceObject::create(inst));
+
+            item.instanceStore->splice(0, item.instanceStore->get_n_items(), objs);
+            if (item.instanceSearch != nullptr) item.instanceSearch->set_visible(item.entry.count_instances >= INSTANCE_SEARCH_MIN);
+        }
+
+        // the dock must not hide while one of its popovers is hovered
+        void keepDockVisibleOnHover(Gtk::Popover * popover)
+        {
+            auto motion_controller = Gtk::EventControllerMotion::create();
+
+            motion_controller->signal_enter().connect([this](double x, double y) {
+                this->setWantedState(Win::DockState::Visible);
+            });
+
+            motion_controller->signal_leave().connect([this]() {
+                this->setWantedState(Win::DockState::Visible);
+            });
+
+            popover->add_controller(motion_controller);
+        }
+
+        void ensureMenu(DockItem& item)
+        {
+            if (item.menu != nullptr) return;
+
+            item.menu = get_Menu(item);
+            item.menu->set_parent(*dock_view);
+            keepDockVisibleOnHover(item.menu);
+        }
+
+        // popovers aren't children of the widget tree, they have to be unparented by hand
+        void dropMenu(DockItem& item)
+        {
+            // window popovers get unparented when their rows are torn down
+            item.instanceStore.reset();
+            item.instanceSearch = nullptr;
+
+            if (item.menu != nullptr && item.menu->get_parent()) item.menu->unparent();
+            item.menu = nullptr;
+        }
+
+        // puts dock_view where edge / alignment want it, its size changes with the number of entries
+        void placeDockBox()
+        {
+            double x = 0;
+            double y = 0;
+            auto setXY = [&x, &y](double px, double py) { x = px; y = py; };
+
             if (appCtx.exclusiveMode)
             {
                 if (appCtx.edge == DockEdge::EDGELEFT || appCtx.edge == DockEdge::EDGERIGHT)
                 {
                     if (appCtx.alignment == DockAlignment::CENTER)
-                        container->put(*dock_box, appCtx.padding, appCtx.padding + (appCtx.winH - appCtx.dockH) * 0.5);
+                        setXY(appCtx.padding, appCtx.padding + (appCtx.winH - appCtx.dockH) * 0.5);
                     else if (appCtx.alignment == DockAlignment::TOP)
-                        container->put(*dock_box, appCtx.padding, appCtx.padding );
+                        setXY(appCtx.padding, appCtx.padding);
                     else if (appCtx.alignment == DockAlignment::BOTTOM)
-                        container->put(*dock_box, appCtx.padding, appCtx.winH - appCtx.dockH - appCtx.padding );
+                        setXY(appCtx.padding, appCtx.winH - appCtx.dockH - appCtx.padding);
                 } else
                 {
                     if (appCtx.alignment == DockAlignment::CENTER)
-                        container->put(*dock_box, appCtx.padding + (appCtx.winW - appCtx.dockW) * 0.5, appCtx.padding);
+                        setXY(appCtx.padding + (appCtx.winW - appCtx.dockW) * 0.5, appCtx.padding);
                     else if (appCtx.alignment == DockAlignment::LEFT)
-                        container->put(*dock_box, appCtx.padding, appCtx.padding);
+                        setXY(appCtx.padding, appCtx.padding);
                     else if (appCtx.alignment == DockAlignment::RIGHT)
-                        container->put(*dock_box, appCtx.winW - appCtx.dockW, appCtx.padding);
+                        setXY(appCtx.winW - appCtx.dockW, appCtx.padding);
                 }
             } else
             {
-                container->put(*dock_box, appCtx.padding, appCtx.padding * 0.5);
+                setXY(appCtx.padding, appCtx.padding * 0.5);
             }
-            
-            set_child(*container);
+
+            // magnified icons grow away from the screen edge into the extra room (magnifyRoom())
+            if (appCtx.edge == DockEdge::EDGEBOTTOM) y += magnifyRoom();
+            else if (appCtx.edge == DockEdge::EDGERIGHT) x += magnifyRoom();
+
+            container->move(*dock_view, x, y);
+
+            // the bar covers the window except the magnification room, the window itself stays transparent (.dockwin)
+            int room = magnifyRoom();
+            Gdk::Rectangle bar;
+
+            if (appCtx.edge == DockEdge::EDGEBOTTOM) bar = Gdk::Rectangle(-x, -y + room, appCtx.winW, appCtx.winH - room);
+            else if (appCtx.edge == DockEdge::EDGETOP) bar = Gdk::Rectangle(-x, -y, appCtx.winW, appCtx.winH - room);
+            else if (appCtx.edge == DockEdge::EDGERIGHT) bar = Gdk::Rectangle(-x + room, -y, appCtx.winW - room, appCtx.winH);
+            else bar = Gdk::Rectangle(-x, -y, appCtx.winW - room, appCtx.winH);
+
+            dock_view->setBar(bar);
         }
 
-        // cleans up docks widgets and their children and handles popovers
-        void cleanupDock() 
+        // px icons get drawn at, the biggest they get while magnified
+        int iconLookupSize()
         {
-            for (auto* popover : popoversofpopovers) {
-                if (popover) {
-                    if (popover->get_parent()) {
-                        popover->unparent();
-                    }
-                }
-            }
-            popoversofpopovers.clear();
-
-            for (auto* popover : popovers) {
-                if (popover) {
-                    if (popover->get_parent()) {
-                        popover->unparent();
-                    }
-                }
-            }
-            popovers.clear();
-            widget_positions.clear();
-            
-            // Now safely remove all children
-            //auto children = dock_box->get_children();
-            //for (auto* child : children) dock_box->remove(*child);
+            return std::ceil(appCtx.icon_size * std::max(appCtx.magnification, 1.0));
         }
 
-        void add_widget_to_dock_box(Gtk::Widget& w, double x, double y)
+        int monitorScale()
         {
-            dock_box->put(w, x, y);
-            widget_positions.push_back({x,y});
+            GdkMonitor * monitor = GDK_MONITOR((Gdk::Display::get_default()->get_monitors()->get_object(appCtx.displayIdx))->gobj());
+            return gdk_monitor_get_scale_factor(monitor);
         }
 
-        std::vector<Gtk::Popover *> popovers;
-        std::vector<Gtk::Popover *> popoversofpopovers;
+        // px the window is wider across the edge than the dock so magnified icons fit
+        int magnifyRoom()
+        {
+            return std::ceil(std::max(appCtx.magnification - 1.0, 0.0) * appCtx.icon_bg_size);
+        }
 
-        Gtk::Fixed * dock_box;
-        Gtk::Fixed * container;
-        float t1 = 0;
-        float t2 = 0;
+        DockView * dock_view = nullptr;
+        Gtk::Fixed * container = nullptr;
 
-        struct point { double x, y; };
-        std::vector<point> widget_positions = {};
-        
-        bool animateOut(float delta)
+        /*
+            auto hide: setWantedState() is all the pointer handlers / dock updates call
+            Hidden starts the timeout (every call restarts it), after it the content slides out (DockView::setSlide)
+            and only then the margin moves the surface off screen, Visible puts the margin back first and slides the content in
+            an interrupted slide turns around from where it is
+        */
+        void setWantedState(DockState s)
         {
-            if (t1 <= 1)
+            // intellihide: while no window covers the dock it stays, whatever the pointer does
+            if (s == Win::DockState::Hidden && appCtx.intellihide && windowGeometryAvailable() && !dockCovered()) s = Win::DockState::Visible;
+
+            wanted_state = s;
+            if (!appCtx.autohide) return;
+
+            if (s == Win::DockState::Hidden)
             {
-                if (appCtx.edge == DockEdge::EDGEBOTTOM || appCtx.edge == DockEdge::EDGETOP)
-                    GLS_chngMargin(this, -(this->appCtx.winH + this->appCtx.edgeMargin) * t1, appCtx.edge);
-                else
-                    GLS_chngMargin(this, -(this->appCtx.winW + this->appCtx.edgeMargin) * t1, appCtx.edge);
-            
-                t1 += delta;
+                autohideTimer.disconnect();
+                autohideTimer = Glib::signal_timeout().connect([this]() {
+                    if (wanted_state == Win::DockState::Hidden && (state == Win::DockState::Visible || state == Win::DockState::Showing))
+                        startHide();
+                    return false;
+                }, appCtx.timeout);
+                return;
             }
-            else
-            {
+
+            autohideTimer.disconnect();
+            if (state == Win::DockState::Hidden || state == Win::DockState::Hiding) startShow();
+        }
+
+        /*
+            intellihide: the dock hides only while a window on its monitor overlaps it (see window-geometry.h)
+            checkIntellihide() runs whenever the backend reported moved / opened / closed windows or the dock changed size
+            covered: hides like auto hide does unless the pointer is on it, uncovered: shows
+        */
+        void checkIntellihide()
+        {
+            if (!appCtx.intellihide || !windowGeometryAvailable()) return;
+
+            if (!dockCovered()) setWantedState(Win::DockState::Visible);
+            else if (!pointerInside) setWantedState(Win::DockState::Hidden);
+        }
+
+        bool dockCovered()
+        {
+            return windowGeometryOverlaps(appCtx.displayIdx, dockRect());
+        }
+
+        // where the shown dock is in global layout coordinates (monitor geometry + anchors / margin, without the magnification room)
+        WindowRect dockRect()
+        {
+            GdkMonitor * monitor = GDK_MONITOR((Gdk::Display::get_default()->get_monitors()->get_object(appCtx.displayIdx))->gobj());
+
+            GdkRectangle g;
+            gdk_monitor_get_geometry(monitor, &g);
+
+            bool vertical = appCtx.edge == DockEdge::EDGELEFT || appCtx.edge == DockEdge::EDGERIGHT;
+            int along = vertical ? appCtx.winH : appCtx.winW;
+            int across = (vertical ? appCtx.winW : appCtx.winH) - magnifyRoom();
+            int monAlong = vertical ? g.height : g.width;
+            int start = (monAlong - along) / 2;
+
+            if (appCtx.alignment == DockAlignment::LEFT || appCtx.alignment == DockAlignment::TOP) start = 0;
+            else if (appCtx.alignment == DockAlignment::RIGHT || appCtx.alignment == DockAlignment::BOTTOM) start = monAlong - along;
+
+            if (appCtx.edge == DockEdge::EDGEBOTTOM) return { g.x + start, g.y + g.height - appCtx.edgeMargin - across, along, across };
+            if (appCtx.edge == DockEdge::EDGETOP) return { g.x + start, g.y + appCtx.edgeMargin, along, across };
+            if (appCtx.edge == DockEdge::EDGERIGHT) return { g.x + g.width - appCtx.edgeMargin - across, g.y + start, across, along };
+            return { g.x + appCtx.edgeMargin, g.y + start, across, along };
+        }
+
+        // how far the content has to move to be out of the window and in which direction
+        void applySlide()
+        {
+            double d = slide.value;
+
+            if (appCtx.edge == DockEdge::EDGEBOTTOM) dock_view->setSlide(0, d * (appCtx.winH + appCtx.edgeMargin));
+            else if (appCtx.edge == DockEdge::EDGETOP) dock_view->setSlide(0, -d * (appCtx.winH + appCtx.edgeMargin));
+            else if (appCtx.edge == DockEdge::EDGERIGHT) dock_view->setSlide(d * (appCtx.winW + appCtx.edgeMargin), 0);
+            else dock_view->setSlide(-d * (appCtx.winW + appCtx.edgeMargin), 0);
+        }
+
+        void startHide()
+        {
+            state = Win::DockState::Hiding;
+            slide.retarget(1, appCtx.duration, 1, Easing::EASE_IN_CUBIC);
+
+            animator.animate(slide, [this]() { applySlide(); }, [this]() {
+                state = Win::DockState::Hidden;
+                pollSchedulerSetHidden(true);
+
+                // the surface moves onto the screen edge (like the Hotspot window) and only listens on the hotspot strip,
+                // the content is slid out by more than edgeMargin so it stays out of view
+                if (appCtx.merged_hotspot)
+                {
+                    GLS_chngMargin(this, 0, appCtx.edge);
+                    applyInputRegion();
+                    return;
+                }
+
+                // content is out of view, one commit moves the surface away
                 if (appCtx.edge == DockEdge::EDGEBOTTOM || appCtx.edge == DockEdge::EDGETOP)
                     GLS_chngMargin(this, -(this->appCtx.winH + this->appCtx.edgeMargin), appCtx.edge);
                 else
                     GLS_chngMargin(this, -(this->appCtx.winW + this->appCtx.edgeMargin), appCtx.edge);
-                
-                t1 = 0;
-                return false;
-            }
+            });
+        }
 
-            return true;  
+        void startShow()
+        {
+            bool wasHidden = state == Win::DockState::Hidden;
+            state = Win::DockState::Showing;
+
+            // surface is off screen / only takes input on the hotspot strip once fully hidden, undo that before sliding in
+            if (wasHidden) GLS_chngMargin(this, this->appCtx.edgeMargin, appCtx.edge);
+            if (wasHidden && appCtx.merged_hotspot) applyInputRegion();
+
+            pollSchedulerSetHidden(false);
+            slide.retarget(0, appCtx.duration, 1, Easing::EASE_OUT_CUBIC);
+
+            animator.animate(slide, [this]() { applySlide(); }, [this]() {
+                state = Win::DockState::Visible;
+            });
         }
 
-        bool animateIn(float delta)
+        /*
+            merged_hotspot: instead of a second window catching the pointer at the screen edge
+            the hidden dock keeps its surface mapped at margin 0 and shrinks its input region to a hotspot_height strip on the edge side
+            entering the strip is an enter on the dock window itself, showing puts edgeMargin and the input region back
+
+            magnification: the window is wider across the edge by magnifyRoom(), the input region leaves that room out in every mode
+        */
+        bool shapesInput()
         {
-            if (t2 <= 1)
-            {
-                if (appCtx.edge == DockEdge::EDGEBOTTOM || appCtx.edge == DockEdge::EDGETOP)
-                    GLS_chngMargin(this, -(this->appCtx.winH + this->appCtx.edgeMargin) * (1 - t2) + this->appCtx.edgeMargin, appCtx.edge);
-                else
-                    GLS_chngMargin(this, -(this->appCtx.winW + this->appCtx.edgeMargin) * (1 - t2) + this->appCtx.edgeMargin, appCtx.edge);    
+            return appCtx.merged_hotspot || magnifyRoom() > 0;
+        }
 
-                t2 += delta;
-            }
-            else
+        void applyInputRegion()
+        {
+            auto surface = get_surface();
+            if (!surface) return;
+
+            int w = get_width();
+            int h = get_height();
+            int hs = appCtx.hotspot_height;
+            int room = magnifyRoom();
+            cairo_rectangle_int_t r = { 0, 0, w, h };
+
+            // the magnification room is only drawn into, windows below it stay clickable and it isn't "on the dock"
+            if (appCtx.edge == DockEdge::EDGEBOTTOM) r = { 0, room, w, h - room };
+            else if (appCtx.edge == DockEdge::EDGETOP) r = { 0, 0, w, h - room };
+            else if (appCtx.edge == DockEdge::EDGELEFT) r = { 0, 0, w - room, h };
+            else r = { room, 0, w - room, h };
+
+            if (state == Win::DockState::Hidden && appCtx.merged_hotspot)
             {
-                GLS_chngMargin(this, this->appCtx.edgeMargin, appCtx.edge);
-
-                t2 = 0;
-                return false;
+                if (appCtx.edge == DockEdge::EDGEBOTTOM) r = { 0, h - hs, w, hs };
+                else if (appCtx.edge == DockEdge::EDGETOP) r = { 0, 0, w, hs };
+                else if (appCtx.edge == DockEdge::EDGELEFT) r = { 0, 0, hs, h };
+                else r = { w - hs, 0, hs, h };
             }
 
-            return true;  
+            cairo_region_t * region = cairo_region_create_rectangle(&r);
+            gdk_surface_set_input_region(surface->gobj(), region);
+            cairo_region_destroy(region);
         }
 
         //populates instance menu with widgets
@@ -899,11 +1057,109 @@ class Win : public Gtk::Window
             popover_box->append(*button1);
         }
 
-        // creates popvermenu from an appentry
-        Gtk::Popover * get_Menu(AppEntry& e)
+        /*
+            window list of an app menu: a list view over item.instanceStore, only visible rows exist and get recycled while scrolling
+            every row owns one window popover that gets filled with the row's current window when it opens
+        */
+        Gtk::Widget * get_InstanceList(DockItem& item)
         {
+            auto box = Gtk::make_managed<Gtk::Box>(Gtk::Orientation::VERTICAL);
+            box->set_spacing(5);
+
+            item.instanceStore = Gio::ListStore<InstanceObject>::create();
+
+            auto search = Gtk::make_managed<Gtk::SearchEntry>();
+            search->add_css_class("isearch");
+            item.instanceSearch = search;
+            box->append(*search);
+
+            // titles containing what got typed, ignoring case and punctuation
+            auto filter = Gtk::CustomFilter::create([search](const Glib::RefPtr<Glib::ObjectBase>& obj) {
+                auto i = std::dynamic_pointer_cast<InstanceObject>(obj);
+                std::string needle = normalizeString(search->get_text());
+                return needle.empty() || (i && normalizeString(i->inst.title).find(needle) != std::string::npos);
+            });
+
+            search->signal_search_changed().connect([filter]() {
+                filter->changed(Gtk::Filter::Change::DIFFERENT);
+            });
+
+            auto factory = Gtk::SignalListItemFactory::create();
+
+            factory->signal_setup().connect([this](const Glib::RefPtr<Gtk::ListItem>& list_item) {
+                auto menubtn = Gtk::make_managed<Gtk::Button>();
+                menubtn->add_css_class("mbutton");
+
+                auto row = Gtk::make_managed<Gtk::Box>(Gtk::Orientation::HORIZONTAL);
+                row->set_spacing(5);
+
+                auto label = Gtk::make_managed<Gtk::Label>();
+                label->set_hexpand(true);
+                label->set_ellipsize(Pango::EllipsizeMode::END);
+                label->set_max_width_chars(20);
+                label->set_halign(Gtk::Align::CENTER);
+
+                auto img = Gtk::make_managed<Gtk::Image>(Gio::Icon::create("pan-end-symbolic"));
+                img->set_halign(Gtk::Align::END);
+
+                row->append(*label);
+                row->append(*img);
+                menubtn->set_child(*row);
+
+                auto i_popover = Gtk::make_managed<Gtk::Popover>();
+                i_popover->set_position(Gtk::PositionType::RIGHT);
+                if (appCtx.edge == DockEdge::EDGERIGHT) i_popover->set_position(Gtk::PositionType::LEFT);
+
+                i_popover->set_parent(*menubtn);
+                keepDockVisibleOnHover(i_popover);
+
+                // rows get rebound to other windows, look up the window when clicked
+                menubtn->signal_clicked().connect([this, i_popover, li = list_item.get()](){
+                    auto i = std::dynamic_pointer_cast<InstanceObject>(li->get_item());
+                    if (!i) return;
+
+                    populateInstanceMenu(i_popover, i->inst);
+                    i_popover->popup(); // Show the dropdown
+                });
+
+                list_item->set_child(*menubtn);
+            });
+
+            factory->signal_bind().connect([](const Glib::RefPtr<Gtk::ListItem>& list_item) {
+                auto i = std::dynamic_pointer_cast<InstanceObject>(list_item->get_item());
+                auto label = dynamic_cast<Gtk::Label *>(list_item->get_child()->get_first_child()->get_first_child());
+
+                if (i && label) label->set_text(i->inst.title);
+            });
+
+            factory->signal_teardown().connect([](const Glib::RefPtr<Gtk::ListItem>& list_item) {
+                // the row's window popover isn't a child of the widget tree, it has to be unparented by hand
+                auto popover = dynamic_cast<Gtk::Popover *>(list_item->get_child()->get_last_child());
+                if (popover) popover->unparent();
+            });
+
+            auto filtered = Gtk::FilterListModel::create(item.instanceStore, filter);
+            auto list = Gtk::make_managed<Gtk::ListView>(Gtk::NoSelection::create(filtered), factory);
+            list->add_css_class("ilist");
+
+            auto scroll = Gtk::make_managed<Gtk::ScrolledWindow>();
+            scroll->set_policy(Gtk::PolicyType::NEVER, Gtk::PolicyType::AUTOMATIC);
+            scroll->set_propagate_natural_height(true);
+            scroll->set_max_content_height(INSTANCE_LIST_MAX_HEIGHT);
+            scroll->set_child(*list);
+            box->append(*scroll);
+
+            fillInstanceStore(item);
+            return box;
+        }
+
+        // creates popvermenu from the entry of a dock item, the window list is backed by item.instanceStore
+        Gtk::Popover * get_Menu(DockItem& item)
+        {
+            const AppEntry& e = item.entry;
+            DockItem * self = &item;
+
             auto m_popover = Gtk::make_managed<Gtk::Popover>();
-            popovers.push_back(m_popover);
             m_popover->set_size_request(3*appCtx.icon_bg_size, -1);
             m_popover->set_expand(false);
             
@@ -933,59 +1189,7 @@ class Win : public Gtk::Window
                 
                 if (e.count_instances > 0)
                 {
-                    for (AppInstance& instance : e.instances)
-                    {
-                        auto menubtn = Gtk::make_managed<Gtk::Button>();
-                        menubtn->add_css_class("mbutton");
-                        
-                        auto click_gesture = Gtk::GestureClick::create();
-                        
-                        auto i_popover = Gtk::make_managed<Gtk::Popover>();
-                        popoversofpopovers.push_back(i_popover);
-
-                        populateInstanceMenu(i_popover, instance);
-
-                        i_popover->set_position(Gtk::PositionType::RIGHT);
-                        if (appCtx.edge == DockEdge::EDGERIGHT) i_popover->set_position(Gtk::PositionType::LEFT);
-
-                        i_popover->set_parent(*menubtn);
-                        i_popover->signal_realize().connect([i_popover, this]() {
-                            auto motion_controller = Gtk::EventControllerMotion::create();
-
-                            motion_controller->signal_enter().connect([i_popover, this](double x, double y) {
-                                this->wanted_state = Win::DockState::Visible;                        
-                            });
-
-                            motion_controller->signal_leave().connect([i_popover, this]() {
-                                this->wanted_state = Win::DockState::Visible;               
-                            });
-                            
-                            i_popover->add_controller(motion_controller);
-                        });
-
-                        menubtn->signal_clicked().connect([this, menubtn, click_gesture, instance, i_popover](){
-                            i_popover->popup(); // Show the dropdown
-                        });
-
-
-                        auto box =  Gtk::make_managed<Gtk::Box>(Gtk::Orientation::HORIZONTAL);
-                        box->set_spacing(5);
-                        
-                        auto label = Gtk::make_managed<Gtk::Label>(instance.title);
-                        label->set_hexpand(true);
-                        label->set_ellipsize(Pango::EllipsizeMode::END);
-                        label->set_max_width_chars(20);
-                        label->set_halign(Gtk::Align::CENTER);
-                        
-                        auto img = Gtk::make_managed<Gtk::Image>(Gio::Icon::create("pan-end-symbolic"));
-                        img->set_halign(Gtk::Align::END);
-
-                        box->append(*label);
-                        box->append(*img);
-
-                        menubtn->set_child(*box);
-                        m_popover_box->append(*menubtn);
-                    }
+                    m_popover_box->append(*get_InstanceList(item));
 
                     auto separator2 = Gtk::make_managed<Gtk::Separator>(Gtk::Orientation::HORIZONTAL);
                     separator2->add_css_class("sepe");
@@ -1003,8 +1207,9 @@ class Win : public Gtk::Window
                 if (e.count_instances > 0)
                 {
                     auto button2 = Gtk::make_managed<Gtk::Button>((e.instances.size() > 1) ? "Close All Windows" : "Close Window");
-                    button2->signal_clicked().connect([e](){
-                        closeInstance(e.instances);
+                    button2->signal_clicked().connect([self](){
+                        // titles may have changed since the menu got built
+                        closeInstance(self->entry.instances);
                     });
 
                     button2->add_css_class("mbutton");
@@ -1048,6 +1253,8 @@ class Win : public Gtk::Window
                         } else {
                             std::cerr << "Error opening files!" << std::endl;
                         }                    }
+
+                    refreshEntries();
                 });
 
                 button3->add_css_class("mbutton");
@@ -1081,60 +1288,6 @@ class Win : public Gtk::Window
             
             return m_popover;
         }
-
-        // creates entries vector orders them correctly (pinned seperator unpinned launcher) and adds launcher
-        std::vector<AppEntry> loadEntries()
-        {
-            std::vector<AppEntry> entries = getEntries(appCtx.isolated_to_monitor, appCtx.displayIdx);
-
-            std::vector <AppEntry> pinned = {};
-            std::ifstream file(getRes("conf/pinnedApps"));
-
-            // Check if the file was opened successfully
-            if (!file.is_open()) {
-                std::cerr << "Error: Could not open Pinned apps file " << std::endl;
-            }
-
-            std::string line;
-
-            while (std::getline(file, line))
-            {
-                std::vector<std::string> values = splitStr(line, ":");
-        
-                AppEntry e = {0, true, values[0], values[1], values[2], values[3]};
-                e.count_instances = 0;
-                pinned.push_back(e);
-            }
-
-            file.close();
-
-            for (AppEntry& pentry : pinned)
-            {
-                int i = 0;
-                for (AppEntry& entry : entries)
-                {
-                    if (pentry.app.name == entry.app.name)
-                    {
-                        entry.isPinned = true;
-                        pentry = entry;
-                        entries.erase(entries.begin()+i);
-                    }
-                    i++;
-                }
-            }
-
-            if (pinned.size() > 0 && entries.size() > 0) pinned.push_back( {0, false, "line"} );
-            entries.insert(entries.begin(), pinned.begin(), pinned.end());
-
-            if (appCtx.drawLauncher)
-            {
-                entries.push_back( {
-                    0, true, "Launcher", appCtx.launcher_cmd, getRes("imgs/launcher.png")
-                } );
-            }
-
-            return entries;
-        }
 };
 
 // hotspot to trigger dock appearance in certain zone
@@ -1166,14 +1319,10 @@ class Hotspot : public Gtk::Window
             auto motion = Gtk::EventControllerMotion::create();
 
             motion->signal_enter().connect([this, win] (double, double) {
-                if (win->state == Win::DockState::Hidden || win->state == Win::DockState::Hiding)
-                {
-                    win->wanted_state = Win::DockState::Visible;                        
-                }
-                if (win->wanted_state == Win::DockState::Hidden)
-                {
-                    win->wanted_state = Win::DockState::Visible;                        
-                }
+                // dock is about to be shown, make sure it doesn't show stale windows
+                pollSchedulerKick();
+
+                win->setWantedState(Win::DockState::Visible);
             });
 
             motion->signal_motion().connect([this](double x, double y) mutable {
@@ -1188,15 +1337,13 @@ class Hotspot : public Gtk::Window
                 {
                     if ((last_x <= win->appCtx.padding || last_x >= win->appCtx.winW - win->appCtx.padding) && (win->state == Win::DockState::Visible || win->state == Win::DockState::Showing))
                     {
-                        win->timeWhenMouseLeftDock = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
-                        win->wanted_state = Win::DockState::Hidden;
+                        win->setWantedState(Win::DockState::Hidden);
                     }
                 } else
                 {
                     if ((last_y <= win->appCtx.padding || last_y >= win->appCtx.winH - win->appCtx.padding) && (win->state == Win::DockState::Visible || win->state == Win::DockState::Showing))
                     {
-                        win->timeWhenMouseLeftDock = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
-                        win->wanted_state = Win::DockState::Hidden;
+                        win->setWantedState(Win::DockState::Hidden);
                     }
                 }
             });
@@ -1227,6 +1374,40 @@ class Hotspot : public Gtk::Window
         }
 };
 
+/*
+    startInstanceMonitoring: feeds the entry pipeline with instances using the first window backend that probes successfully
+    (shared objects in backends/, then hyprland > sway / i3 > wlr-foreign-toplevel > X11, see backend.h)
+    without a backend list_windows.bash runs as a streaming coprocess (see script-stream.h)
+    polls the backend / a one shot list_windows.bash if nothing pushes events
+    has to run after gtk is initialized since the foreign toplevel and X11 backends share gdk's display
+*/
+
+void startInstancePolling()
+{
+    std::thread monitoringThread([](){
+        while (running)
+        {
+            // interval adapts to how often things change and whether the dock is visible
+            pollSchedulerWait(pushInstances(getRunningInstances()));
+        }
+    });
+
+    monitoringThread.detach();
+}
+
+void startInstanceMonitoring()
+{
+    if (startBackend(pushInstances)) return;
+
+    if (activeBackend() == nullptr)
+    {
+        scriptStreamStart(pushInstances, startInstancePolling);
+        return;
+    }
+
+    startInstancePolling();
+}
+
 int main (int argc, char **argv)
 {
     chdir_to_parentpath();
@@ -1235,10 +1416,22 @@ int main (int argc, char **argv)
     check_layer_shell_support();
 
     auto app = Gtk::Application::create();
-   
-    DesktopFiles = findDesktopFiles();
+
+    // icons get resolved in the theme gtk would use
+    if (auto settings = Gtk::Settings::get_default())
+    {
+        iconIndexSetTheme(settings->property_gtk_icon_theme_name().get_value());
+        // icon paths get resolved when desktop files are parsed, the new theme needs them parsed again
+        settings->property_gtk_icon_theme_name().signal_changed().connect([settings]() {
+            iconIndexSetTheme(settings->property_gtk_icon_theme_name().get_value());
+            rescanDesktopFiles();
+        });
+    }
+
 
     app->signal_startup().connect([app, argc, argv](){
+        startInstanceMonitoring();
+
         auto win = Gtk::make_managed<Win>(argc, argv);
         
         Glib::RefPtr<Gtk::CssProvider> css_provider = Gtk::CssProvider::create();
@@ -1250,22 +1443,14 @@ int main (int argc, char **argv)
         app->add_window(*win);
         win->present();
 
+        // merged_hotspot: the dock window catches the pointer itself while hidden
+        if (win->appCtx.merged_hotspot) return;
+
         auto hotspot = Gtk::make_managed<Hotspot>(argc,argv, win);
         hotspot->get_style_context()->add_provider_for_display(Gdk::Display::get_default(), css_provider, GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
         app->add_window(*hotspot);
         hotspot->present();
     });
 
-    std::thread monitoringThread([](){
-        while (running)
-        {
-            {
-                std::lock_guard<std::mutex> lock(instances_mutex);
-                current_instances = getRunningInstances();
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(250));
-        }
-    });
-
     return app->run();
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "pid-resolver.h"
+#include <unordered_set>
+#include <sstream>
+
+// pid -> entry index (-1: /proc didn't tell, the class / title matching has to do it)
+static std::unordered_map<int, int> pidCache = {};
+
+static std::string readProcFile(int pid, const std::string& name)
+{
+    std::ifstream file("/proc/" + std::to_string(pid) + "/" + name, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// value of key in the NUL separated environment of pid, "" if unset or unreadable (other users' processes)
+static std::string environValue(int pid, const std::string& key)
+{
+    if (pid <= 0) return "";
+
+    std::string env = readProcFile(pid, "environ");
+    std::string prefix = key + "=";
+    size_t start = 0;
+
+    while (start < env.size())
+    {
+        size_t end = env.find('\0', start);
+        if (end == std::string::npos) end = env.size();
+
+        if (env.compare(start, prefix.size(), prefix) == 0)
+            return env.substr(start + prefix.size(), end - start - prefix.size());
+
+        start = end + 1;
+    }
+
+    return "";
+}
+
+static int parentPid(int pid)
+{
+    // "pid (comm) state ppid ...", comm may contain spaces and parentheses
+    std::string stat = readProcFile(pid, "stat");
+    size_t close = stat.rfind(')');
+    if (close == std::string::npos) return -1;
+
+    std::vector<std::string> fields = splitStr(stat.substr(close + 2), " ");
+    return (fields.size() > 1) ? std::atoi(fields[1].c_str()) : -1;
+}
+
+// innermost app-*.scope / app-*.service cgroup of pid, "" if it isn't in one
+static std::string appUnit(int pid)
+{
+    if (pid <= 0) return "";
+
+    std::istringstream cgroup(readProcFile(pid, "cgroup"));
+    std::string line;
+
+    // cgroup v2 has a single "0::/path" line, v1 one line per hierarchy
+    while (std::getline(cgroup, line))
+    {
+        size_t sep = line.find(':', line.find(':') + 1);
+        if (sep == std::string::npos) continue;
+
+        std::vector<std::string> parts = splitStr(line.substr(sep + 1), "/");
+
+        for (auto it = parts.rbegin(); it != parts.rend(); it++)
+        {
+            const std::string& p = *it;
+            bool unit = (p.size() > 6 && p.compare(p.size() - 6, 6, ".scope") == 0) || (p.size() > 8 && p.compare(p.size() - 8, 8, ".service") == 0);
+
+            if (unit && p.rfind("app-", 0) == 0) return p;
+        }
+    }
+
+    return "";
+}
+
+// systemd escapes '-' inside names as \x2d
+static std::string unescapeUnit(const std::string& s)
+{
+    std::string res = "";
+
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        if (s[i] == '\\' && i + 3 < s.size() && s[i + 1] == 'x')
+        {
+            res += (char)std::strtol(s.substr(i + 2, 2).c_str(), nullptr, 16);
+            i += 3;
+        } else
+        {
+            res += s[i];
+        }
+    }
+
+    return res;
+}
+
+/*
+    app ids a unit name may carry, most likely first
+        app-[<launcher>-]<id>-<random>.scope
+        app-[<launcher>-]<id>[@<random>].service
+    ex. "app-gnome-org.gnome.Terminal-4242.scope" --> {"org.gnome.Terminal", "gnome-org.gnome.Terminal"}
+*/
+static std::vector<std::string> appIdsOfUnit(const std::string& unit)
+{
+    std::string name = unit.substr(4);
+
+    if (name.compare(name.size() - 6, 6, ".scope") == 0)
+    {
+        name.erase(name.size() - 6);
+        size_t dash = name.rfind('-');
+        if (dash == std::string::npos) return {};
+        name.erase(dash);
+    } else
+    {
+        name.erase(name.size() - 8);
+        size_t at = name.find('@');
+        if (at != std::string::npos) name.erase(at);
+    }
+
+    std::vector<std::string> ids = {};
+    size_t dash = name.find('-');
+
+    if (dash != std::string::npos) ids.push_back(unescapeUnit(name.substr(dash + 1)));
+    ids.push_back(unescapeUnit(name));
+
+    return ids;
+}
+
+static int entryOfDesktopFile(const std::string& path, const DesktopIndex& index)
+{
+    int i = index.find(path);
+    return (i >= 0) ? i : index.findId(desktopFileId(path));
+}
+
+static int resolveUncached(int pid, const DesktopIndex& index)
+{
+    int parent = parentPid(pid);
+
+    // 1. the launcher told the process which desktop file it came from
+    std::string launched = environValue(pid, "GIO_LAUNCHED_DESKTOP_FILE");
+    if (!launched.empty() && environValue(pid, "GIO_LAUNCHED_DESKTOP_FILE_PID") == std::to_string(pid))
+    {
+        int i = entryOfDesktopFile(launched, index);
+        if (i >= 0) return i;
+    }
+
+    std::string hint = environValue(pid, "BAMF_DESKTOP_FILE_HINT");
+    if (!hint.empty() && hint != environValue(parent, "BAMF_DESKTOP_FILE_HINT"))
+    {
+        int i = entryOfDesktopFile(hint, index);
+        if (i >= 0) return i;
+    }
+
+    // 2. the systemd unit the launcher started it in
+    std::string unit = appUnit(pid);
+    if (!unit.empty() && (unit.rfind("app-flatpak-", 0) == 0 || unit != appUnit(parent)))
+    {
+        for (const std::string& id : appIdsOfUnit(unit))
+        {
+            int i = index.findId(id);
+            if (i >= 0) return i;
+        }
+    }
+
+    // 3. the binary itself
+    std::error_code ec;
+    std::string exe = std::filesystem::read_symlink("/proc/" + std::to_string(pid) + "/exe", ec).string();
+
+    // binaries replaced by an update show up as "/usr/bin/foo (deleted)"
+    if (exe.size() > 10 && exe.compare(exe.size() - 10, 10, " (deleted)") == 0) exe.erase(exe.size() - 10);
+
+    if (!exe.empty())
+    {
+        int i = index.findExec(exe);
+        if (i >= 0) return i;
+    }
+
+    // apps started through a symlink (/usr/bin/code -> /usr/share/code/code) still have it as argv[0]
+    std::string cmdline = readProcFile(pid, "cmdline");
+    std::string argv0 = cmdline.substr(0, cmdline.find('\0'));
+
+    if (!argv0.empty() && argv0 != exe) return index.findExec(argv0);
+
+    return -1;
+}
+
+int resolvePid(int pid, const DesktopIndex& index)
+{
+    if (pid <= 0) return -1;
+
+    auto it = pidCache.find(pid);
+    if (it != pidCache.end()) return it->second;
+
+    int i = resolveUncached(pid, index);
+    pidCache[pid] = i;
+    return i;
+}
+
+void pidResolverPrune(const std::vector<AppInstance>& instances)
+{
+    std::unordered_set<int> alive = {};
+    for (const AppInstance& inst : instances)
+        alive.insert(inst.pid);
+
+    for (auto it = pidCache.begin(); it != pidCache.end();)
+    {
+        if (alive.count(it->first) == 0) it = pidCache.erase(it);
+        else it++;
+    }
+}
+
+void pidResolverClear()
+{
+    pidCache.clear();
+}
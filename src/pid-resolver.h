@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "utils.h"
+#include "desktop-index.h"
+
+/*
+    pid -> desktop entry resolution through /proc, exact instead of guessing from class / title
+    checked in this order:
+        1. environ: GIO_LAUNCHED_DESKTOP_FILE (only if GIO_LAUNCHED_DESKTOP_FILE_PID is this pid), BAMF_DESKTOP_FILE_HINT
+        2. cgroup: systemd scopes / services launchers put apps in (app-flatpak-org.foo.Bar-1234.scope, app-gnome-firefox-1234.scope ...)
+        3. exe / argv[0] against the binaries in the indexed Exec lines
+    1. and 2. get inherited by child processes (a game started by steam), they only count if the parent process doesn't share them
+    flatpak scopes are the exception, everything in there belongs to the same app
+
+    results (misses too) are cached per pid as long as the pid owns a window
+    only used from the entry pipeline worker
+*/
+
+// index into index.entries or -1 if /proc doesn't say
+int resolvePid(int pid, const DesktopIndex& index);
+
+// drops pids that don't own any of these windows anymore (process exited, pid may get reused)
+void pidResolverPrune(const std::vector<AppInstance>& instances);
+
+// desktop index got rebuilt, cached indices are meaningless now
+void pidResolverClear();
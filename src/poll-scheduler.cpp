@@ -0,0 +1,67 @@
+#include "poll-scheduler.h"
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <sys/prctl.h>
+
+static std::mutex schedulerMutex;
+static std::condition_variable schedulerCond;
+
+static int minInterval = 250;
+static int maxInterval = 4000;
+static int interval = 250;
+static bool hidden = false;
+static bool kicked = false;
+
+void pollSchedulerConfigure(int minMs, int maxMs)
+{
+    std::lock_guard<std::mutex> lock(schedulerMutex);
+
+    minInterval = std::max(minMs, 10);
+    maxInterval = std::max(maxMs, minInterval);
+    interval = minInterval;
+}
+
+void pollSchedulerSetHidden(bool isHidden)
+{
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        if (hidden == isHidden) return;
+
+        hidden = isHidden;
+        if (!hidden)
+        {
+            interval = minInterval;
+            kicked = true;
+        }
+    }
+
+    schedulerCond.notify_all();
+}
+
+void pollSchedulerKick()
+{
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        interval = minInterval;
+        kicked = true;
+    }
+
+    schedulerCond.notify_all();
+}
+
+void pollSchedulerWait(bool changed)
+{
+    std::unique_lock<std::mutex> lock(schedulerMutex);
+
+    // nobody sees changes of a hidden dock, keep backing off until it gets shown
+    if (changed && !hidden) interval = minInterval;
+    else interval = std::min(interval * 2, maxInterval);
+
+    // let the kernel batch this wakeup with others, a quarter of the interval late doesn't matter
+    prctl(PR_SET_TIMERSLACK, (unsigned long)interval * 1000000UL / 4, 0, 0, 0);
+
+    schedulerCond.wait_for(lock, std::chrono::milliseconds(interval), [](){ return kicked; });
+    kicked = false;
+}
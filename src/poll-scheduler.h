@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+
+/*
+    poll scheduler: decides how long pollers (one shot list_windows.bash, backends without events) sleep between polls
+    starts at the min interval, doubles while polls come back unchanged or the dock is hidden (up to the max interval)
+    and snaps back to min after a change or when the dock gets shown / the hotspot gets entered
+*/
+
+// poll_interval_min / poll_interval_max from settings.conf (ms)
+void pollSchedulerConfigure(int minMs, int maxMs);
+
+// dock finished hiding / started showing
+void pollSchedulerSetHidden(bool hidden);
+
+// something will probably look at the dock soon, poll now and go back to the min interval
+void pollSchedulerKick();
+
+// called by the poller after each poll, sleeps until the next one is due or pollSchedulerKick() got called
+void pollSchedulerWait(bool changed);
@@ -0,0 +1,273 @@
+#include "script-stream.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+
+// seconds a script may take for its first snapshot / sit on an unterminated record before it gets restarted
+static const int STALL_TIMEOUT = 5;
+static const int MAX_RESTART_DELAY = 30;
+
+struct ScriptStream
+{
+    std::function<void(const std::vector<AppInstance>&)> onChange;
+    std::function<void()> onUnsupported;
+
+    GPid pid = 0;
+    bool exited = false;    // pid got reaped, something it spawned may still hold the pipe open
+    int fd = -1;
+    sigc::connection ioConn;
+    sigc::connection childConn;
+
+    std::string buffer = "";
+    bool supported = false;
+    bool disabled = false;
+    bool inSnapshot = false;
+    std::vector<AppInstance> instances = {};
+    std::vector<AppInstance> pending = {};
+
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point lastData;
+    std::chrono::steady_clock::time_point snapshotStarted;
+    std::chrono::steady_clock::time_point exitedAt;
+    int restartDelay = 1;
+};
+
+static ScriptStream stream;
+
+static void startScript();
+
+static void upsert(std::vector<AppInstance>& list, const AppInstance& inst)
+{
+    for (AppInstance& i : list)
+    {
+        if (i.id == inst.id)
+        {
+            i = inst;
+            return;
+        }
+    }
+
+    list.push_back(inst);
+}
+
+static void stopScript()
+{
+    stream.ioConn.disconnect();
+    stream.childConn.disconnect();
+
+    if (stream.fd >= 0) close(stream.fd);
+    stream.fd = -1;
+
+    if (stream.pid > 0)
+    {
+        // whole process group, the script may have spawned socat / hyprctl -i ... for its event stream
+        kill(-stream.pid, SIGTERM);
+        // reaps the child, the callback itself isn't needed anymore
+        if (!stream.exited) Glib::signal_child_watch().connect([](GPid pid, int) { Glib::spawn_close_pid(pid); }, stream.pid);
+    }
+    stream.pid = 0;
+    stream.exited = false;
+
+    stream.buffer = "";
+    stream.inSnapshot = false;
+    stream.pending = {};
+}
+
+static void restartLater()
+{
+    stopScript();
+
+    int delay = stream.restartDelay;
+    stream.restartDelay = std::min(stream.restartDelay * 2, MAX_RESTART_DELAY);
+
+    Glib::signal_timeout().connect_seconds_once([](){ startScript(); }, delay);
+}
+
+static void giveUp()
+{
+    stopScript();
+    stream.disabled = true;
+    std::cout << "list_windows.bash doesn't support --stream, polling it instead" << std::endl;
+    if (stream.onUnsupported) stream.onUnsupported();
+}
+
+// applies one complete message, returns true if the published list changed
+static bool applyMessage(std::string_view command, const AppInstance& inst, std::string_view id)
+{
+    if (command == "snapshot")
+    {
+        stream.supported = true;
+        stream.inSnapshot = true;
+        stream.snapshotStarted = std::chrono::steady_clock::now();
+        stream.pending = {};
+        return false;
+    } else if (command == "done")
+    {
+        if (!stream.inSnapshot) return false;
+
+        stream.inSnapshot = false;
+        // a complete snapshot means the script is healthy
+        stream.restartDelay = 1;
+
+        bool changed = !sameInstances(stream.instances, stream.pending);
+        stream.instances = std::move(stream.pending);
+        stream.pending = {};
+        return changed;
+    } else if (command == "add")
+    {
+        upsert(stream.inSnapshot ? stream.pending : stream.instances, inst);
+        return !stream.inSnapshot;
+    } else if (command == "remove")
+    {
+        std::vector<AppInstance>& list = stream.inSnapshot ? stream.pending : stream.instances;
+        size_t before = list.size();
+
+        list.erase(std::remove_if(list.begin(), list.end(), [&id](const AppInstance& i) { return i.id == id; }), list.end());
+        return !stream.inSnapshot && list.size() != before;
+    }
+
+    // ping and unknown commands
+    return false;
+}
+
+// reads one message starting at pos, false (pos untouched) if it isn't complete yet
+static bool readMessage(std::string_view data, size_t& pos, std::string_view& command, AppInstance& inst, std::string_view& id)
+{
+    size_t p = pos;
+    if (!readRecordField(data, p, command)) return false;
+
+    if (command == "add" && !readInstanceRecord(data, p, inst)) return false;
+    if (command == "remove" && !readRecordField(data, p, id)) return false;
+
+    pos = p;
+    return true;
+}
+
+static bool onReadable(Glib::IOCondition)
+{
+    char chunk[BUFSIZ];
+    bool changed = false;
+    bool eof = false;
+
+    while (true)
+    {
+        ssize_t n = read(stream.fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) break;   // EAGAIN, drained the pipe
+        if (n == 0)
+        {
+            eof = true;
+            break;
+        }
+
+        stream.buffer.append(chunk, n);
+        stream.lastData = std::chrono::steady_clock::now();
+    }
+
+    size_t pos = 0;
+    std::string_view command, id;
+    AppInstance inst;
+
+    while (readMessage(stream.buffer, pos, command, inst, id))
+    {
+        // first message tells if this is a stream capable script
+        if (!stream.supported && command != "snapshot")
+        {
+            giveUp();
+            return false;
+        }
+
+        changed |= applyMessage(command, inst, id);
+    }
+
+    stream.buffer.erase(0, pos);
+
+    // publish once per wakeup, not once per record
+    if (changed && stream.onChange) stream.onChange(stream.instances);
+
+    if (eof)
+    {
+        if (!stream.supported) giveUp();
+        else restartLater();
+        return false;
+    }
+
+    return true;
+}
+
+static void onChildExit(GPid pid, int)
+{
+    Glib::spawn_close_pid(pid);
+    if (pid != stream.pid) return;
+
+    // remaining output is still read from the pipe, onReadable restarts the script at eof
+    // if something the script spawned still holds the pipe open the watchdog restarts it (pid stays as the process group to kill)
+    stream.exited = true;
+    stream.exitedAt = std::chrono::steady_clock::now();
+}
+
+static bool watchdog()
+{
+    if (stream.disabled) return false;
+    if (stream.fd < 0) return true;
+
+    auto now = std::chrono::steady_clock::now();
+    auto timeout = std::chrono::seconds(STALL_TIMEOUT);
+
+    if (!stream.supported && now - stream.started > timeout)
+    {
+        giveUp();
+        return false;
+    }
+
+    if (stream.exited && now - stream.exitedAt > timeout)
+    {
+        std::cerr << "list_windows.bash exited but its output stays open, restarting it" << std::endl;
+        restartLater();
+        return true;
+    }
+
+    bool stalledSnapshot = stream.inSnapshot && now - stream.snapshotStarted > timeout;
+    bool stalledRecord = !stream.buffer.empty() && now - stream.lastData > timeout;
+
+    if (stalledSnapshot || stalledRecord)
+    {
+        std::cerr << "list_windows.bash stalled, restarting it" << std::endl;
+        restartLater();
+    }
+
+    return true;
+}
+
+static void startScript()
+{
+    int out = -1;
+
+    try
+    {
+        Glib::spawn_async_with_pipes(".", { "bash", getRes("conf/list_windows.bash"), "--stream" },
+            Glib::SpawnFlags::SEARCH_PATH | Glib::SpawnFlags::DO_NOT_REAP_CHILD, [](){ setpgid(0, 0); }, &stream.pid, nullptr, &out, nullptr);
+    } catch (const Glib::Error& e)
+    {
+        std::cerr << "Couldn't start list_windows.bash: " << e.what() << std::endl;
+        restartLater();
+        return;
+    }
+
+    fcntl(out, F_SETFL, fcntl(out, F_GETFL) | O_NONBLOCK);
+
+    stream.fd = out;
+    stream.started = stream.lastData = std::chrono::steady_clock::now();
+    stream.ioConn = Glib::signal_io().connect(sigc::ptr_fun(onReadable), out, Glib::IOCondition::IO_IN | Glib::IOCondition::IO_HUP | Glib::IOCondition::IO_ERR);
+    stream.childConn = Glib::signal_child_watch().connect(sigc::ptr_fun(onChildExit), stream.pid);
+}
+
+void scriptStreamStart(const std::function<void(const std::vector<AppInstance>&)>& onChange, const std::function<void()>& onUnsupported)
+{
+    stream.onChange = onChange;
+    stream.onUnsupported = onUnsupported;
+
+    startScript();
+    Glib::signal_timeout().connect_seconds(sigc::ptr_fun(watchdog), 1);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include "utils.h"
+
+/*
+    streaming list_windows.bash: instead of spawning the script every 250ms it gets started once as
+    "bash list_windows.bash --stream" and keeps running, its stdout is read non-blocking from the glib main loop
+
+    stream format, every field is terminated by a NUL byte so titles may contain anything but NUL:
+        snapshot                                        following adds form the complete window list
+        done                                            end of snapshot
+        add ID monitorIdx title class isFullscreen PID  window opened / changed (same record as the one shot output)
+        remove ID                                       window closed
+        ping                                            keepalive, ignored
+    deltas outside of a snapshot get applied immediately
+
+    a watchdog restarts the script if it exits or stalls in the middle of a record
+*/
+
+// starts the script in stream mode (main thread), onChange gets called with the full list after every change
+// if the script doesn't answer with "snapshot" (old one shot script) it gets stopped and onUnsupported is called once
+void scriptStreamStart(const std::function<void(const std::vector<AppInstance>&)>& onChange, const std::function<void()>& onUnsupported);
@@ -0,0 +1,540 @@
+#include "sway-ipc.h"
+#include "backend.h"
+#include "json.h"
+#include "window-geometry.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <poll.h>
+#include <cerrno>
+
+static const char swayMagic[] = "i3-ipc";
+static const size_t swayHeaderSize = 6 + 2 * sizeof(uint32_t);
+
+static const uint32_t SWAY_EVENT_WORKSPACE = 0x80000000;
+static const uint32_t SWAY_EVENT_OUTPUT = 0x80000001;
+static const uint32_t SWAY_EVENT_WINDOW = 0x80000003;
+static const uint32_t SWAY_EVENT_SHUTDOWN = 0x80000006;
+
+static std::string swaySocketPath()
+{
+    const char * sock = std::getenv("SWAYSOCK");
+    if (sock == NULL) sock = std::getenv("I3SOCK");
+    return (sock == NULL) ? "" : sock;
+}
+
+static bool writeAll(int fd, const char * data, size_t size)
+{
+    size_t written = 0;
+    while (written < size)
+    {
+        ssize_t n = send(fd, data + written, size - written, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        written += n;
+    }
+    return true;
+}
+
+static bool readAll(int fd, char * data, size_t size)
+{
+    size_t got = 0;
+    while (got < size)
+    {
+        ssize_t n = read(fd, data + got, size - got);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        got += n;
+    }
+    return true;
+}
+
+static bool sendMessage(int fd, uint32_t type, const std::string& payload)
+{
+    char header[swayHeaderSize];
+    uint32_t len = payload.size();
+
+    std::memcpy(header, swayMagic, 6);
+    std::memcpy(header + 6, &len, sizeof(uint32_t));
+    std::memcpy(header + 6 + sizeof(uint32_t), &type, sizeof(uint32_t));
+
+    return writeAll(fd, header, swayHeaderSize) && writeAll(fd, payload.c_str(), payload.size());
+}
+
+static bool readMessage(int fd, uint32_t& type, std::string& payload)
+{
+    char header[swayHeaderSize];
+    if (!readAll(fd, header, swayHeaderSize) || std::memcmp(header, swayMagic, 6) != 0) return false;
+
+    uint32_t len = 0;
+    std::memcpy(&len, header + 6, sizeof(uint32_t));
+    std::memcpy(&type, header + 6 + sizeof(uint32_t), sizeof(uint32_t));
+
+    payload.resize(len);
+    return len == 0 || readAll(fd, payload.data(), len);
+}
+
+bool swayIpcAvailable()
+{
+    std::string path = swaySocketPath();
+    return !path.empty() && std::filesystem::exists(path);
+}
+
+std::string swayRequest(SwayMessage type, const std::string& payload)
+{
+    int fd = connectUnixSocket(swaySocketPath());
+    if (fd < 0) return "";
+
+    uint32_t replyType = 0;
+    std::string reply;
+
+    if (!sendMessage(fd, (uint32_t)type, payload) || !readMessage(fd, replyType, reply))
+        reply = "";
+
+    close(fd);
+    return reply;
+}
+
+void swayRunCommand(const std::string& command)
+{
+    swayRequest(SwayMessage::RUN_COMMAND, command);
+}
+
+// active outputs in the order sway reports them, used to turn output names into monitor indices
+static std::vector<std::string> swayGetOutputNames()
+{
+    std::vector<std::string> names = {};
+    JsonValue outputs = parseJson(swayRequest(SwayMessage::GET_OUTPUTS, ""));
+
+    for (const JsonValue& o : outputs.items)
+    {
+        if (o["active"].asBool(true)) names.push_back(o["name"].asString());
+    }
+
+    return names;
+}
+
+static int monitorIdxOfOutput(const std::vector<std::string>& outputs, const std::string& name)
+{
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        if (outputs[i] == name) return i;
+    }
+
+    return 0;
+}
+
+// views are leaf containers that belong to a client (sway: pid / app_id, i3: X11 window)
+static bool isView(const JsonValue& node)
+{
+    std::string type = node["type"].asString();
+    if (type != "con" && type != "floating_con") return false;
+    if (node["nodes"].size() != 0 || node["floating_nodes"].size() != 0) return false;
+
+    return node.has("pid") || !node["window"].isNull();
+}
+
+static AppInstance instanceFromContainer(const JsonValue& con, int monitorIdx)
+{
+    AppInstance i;
+    i.monitorIdx = monitorIdx;
+    i.title = con["name"].asString();
+    // wayland clients have an app_id, xwayland / i3 clients a WM_CLASS
+    i.wclass = con["app_id"].asString(con["window_properties"]["class"].asString());
+    i.fullscreen = con["fullscreen_mode"].asInt(0) != 0;
+    i.pid = con["pid"].asInt(-1);
+    i.id = std::to_string(con["id"].asInt(-1));
+
+    if (i.title.empty()) i.title = "-";
+    if (i.wclass.empty()) i.wclass = "-";
+
+    return i;
+}
+
+static void collectViews(const JsonValue& node, const std::vector<std::string>& outputs, int monitorIdx, std::vector<AppInstance>& inst)
+{
+    if (node["type"].asString() == "output")
+        monitorIdx = monitorIdxOfOutput(outputs, node["name"].asString());
+
+    if (isView(node))
+    {
+        inst.push_back(instanceFromContainer(node, monitorIdx));
+        return;
+    }
+
+    for (const JsonValue& child : node["nodes"].items)
+        collectViews(child, outputs, monitorIdx, inst);
+
+    for (const JsonValue& child : node["floating_nodes"].items)
+        collectViews(child, outputs, monitorIdx, inst);
+}
+
+std::vector<AppInstance> swayGetWindows()
+{
+    std::vector<AppInstance> inst = {};
+    std::vector<std::string> outputs = swayGetOutputNames();
+
+    collectViews(parseJson(swayRequest(SwayMessage::GET_TREE, "")), outputs, 0, inst);
+    return inst;
+}
+
+// rect is in global layout coordinates, visible is false for views on workspaces that aren't shown (and hidden scratchpad views)
+static void collectGeometry(const JsonValue& node, const std::vector<std::string>& outputs, int monitorIdx, std::vector<WindowGeometry>& windows)
+{
+    if (node["type"].asString() == "output")
+        monitorIdx = monitorIdxOfOutput(outputs, node["name"].asString());
+
+    if (isView(node))
+    {
+        if (!node["visible"].asBool(true)) return;
+
+        const JsonValue& r = node["rect"];
+        windows.push_back({ std::to_string(node["id"].asInt(-1)), monitorIdx,
+            { (int)r["x"].asInt(), (int)r["y"].asInt(), (int)r["width"].asInt(), (int)r["height"].asInt() } });
+        return;
+    }
+
+    for (const JsonValue& child : node["nodes"].items)
+        collectGeometry(child, outputs, monitorIdx, windows);
+
+    for (const JsonValue& child : node["floating_nodes"].items)
+        collectGeometry(child, outputs, monitorIdx, windows);
+}
+
+static void swaySyncGeometry()
+{
+    std::vector<WindowGeometry> windows = {};
+    collectGeometry(parseJson(swayRequest(SwayMessage::GET_TREE, "")), swayGetOutputNames(), 0, windows);
+    windowGeometrySync(windows);
+}
+
+struct SwayRect
+{
+    int x = 0, y = 0, w = 0, h = 0;
+
+    bool contains(int px, int py) const { return px >= x && py >= y && px < x + w && py < y + h; }
+};
+
+static SwayRect rectOf(const JsonValue& r)
+{
+    return { (int)r["x"].asInt(), (int)r["y"].asInt(), (int)r["width"].asInt(), (int)r["height"].asInt() };
+}
+
+// a workspace as GET_WORKSPACES / workspace events describe it
+struct SwayWorkspace
+{
+    std::string output = "";
+    SwayRect rect;
+};
+
+/*
+    window events don't say where the container is, it gets resolved through the workspaces:
+    the workspace whose rect holds the middle of the container (workspaces on hidden outputs keep their rects too),
+    containers without a rect yet (new windows before they got arranged) are on the focused workspace
+    workspaces / outputs come from GET_WORKSPACES / GET_OUTPUTS once and are kept current from workspace events
+*/
+struct SwayWatchState
+{
+    std::vector<AppInstance> instances = {};
+    std::vector<std::string> outputs = {};
+    std::unordered_map<std::string, SwayWorkspace> workspaces = {};
+    std::string focused = "";
+
+    AppInstance * find(const std::string& id)
+    {
+        for (AppInstance& i : instances)
+        {
+            if (i.id == id) return &i;
+        }
+        return nullptr;
+    }
+
+    void loadWorkspaces()
+    {
+        outputs = swayGetOutputNames();
+        workspaces.clear();
+
+        for (const JsonValue& ws : parseJson(swayRequest(SwayMessage::GET_WORKSPACES, "")).items)
+        {
+            workspaces[ws["name"].asString()] = { ws["output"].asString(), rectOf(ws["rect"]) };
+            if (ws["focused"].asBool()) focused = ws["name"].asString();
+        }
+    }
+
+    // GET_TREE, only on connect and when outputs / workspaces moved between outputs
+    void load()
+    {
+        loadWorkspaces();
+        instances.clear();
+        collectViews(parseJson(swayRequest(SwayMessage::GET_TREE, "")), outputs, 0, instances);
+    }
+
+    int monitorOf(const JsonValue& con)
+    {
+        SwayRect r = rectOf(con["rect"]);
+        std::string output = "";
+
+        if (r.w > 0 && r.h > 0)
+        {
+            for (const auto& [name, ws] : workspaces)
+            {
+                if (!ws.rect.contains(r.x + r.w / 2, r.y + r.h / 2)) continue;
+
+                output = ws.output;
+                break;
+            }
+        }
+
+        auto it = workspaces.find(focused);
+        if (output.empty() && it != workspaces.end()) output = it->second.output;
+
+        return monitorIdxOfOutput(outputs, output);
+    }
+
+    // applies one window event, returns true if the instance list changed
+    bool apply(const JsonValue& ev)
+    {
+        std::string change = ev["change"].asString();
+        const JsonValue& con = ev["container"];
+        std::string id = std::to_string(con["id"].asInt(-1));
+        AppInstance * i = find(id);
+
+        if (change == "new")
+        {
+            if (i != nullptr) return false;
+
+            instances.push_back(instanceFromContainer(con, monitorOf(con)));
+            return true;
+        } else if (change == "close")
+        {
+            if (i == nullptr) return false;
+
+            instances.erase(instances.begin() + (i - instances.data()));
+            return true;
+        } else if (change == "title" || change == "fullscreen_mode")
+        {
+            if (i == nullptr) return false;
+
+            AppInstance updated = instanceFromContainer(con, i->monitorIdx);
+            bool changed = updated.title != i->title || updated.wclass != i->wclass || updated.fullscreen != i->fullscreen;
+            *i = updated;
+            return changed;
+        } else if (change == "move")
+        {
+            if (i == nullptr) return false;
+
+            int before = i->monitorIdx;
+            i->monitorIdx = monitorOf(con);
+            return i->monitorIdx != before;
+        }
+
+        return false;
+    }
+
+    // applies one workspace event, returns true if windows may have changed monitors (the tree has to be reloaded)
+    bool applyWorkspace(const JsonValue& ev)
+    {
+        std::string change = ev["change"].asString();
+        const JsonValue& current = ev["current"];
+        std::string name = current["name"].asString();
+
+        if (change == "focus" || change == "init")
+        {
+            workspaces[name] = { current["output"].asString(), rectOf(current["rect"]) };
+            if (change == "focus") focused = name;
+        } else if (change == "empty")
+        {
+            workspaces.erase(name);
+        } else if (change == "rename")
+        {
+            workspaces.erase(ev["old"]["name"].asString());
+            workspaces[name] = { current["output"].asString(), rectOf(current["rect"]) };
+            if (current["focused"].asBool()) focused = name;
+        } else if (change == "move")
+        {
+            // a whole workspace went to another output, its windows with it
+            return true;
+        } else if (change == "reload")
+        {
+            loadWorkspaces();
+        }
+
+        return false;
+    }
+};
+
+void swayWatchInstances(std::atomic<bool>& running, const std::function<void(const std::vector<AppInstance>&)>& onChange)
+{
+    // i3 restarts in place: its socket goes away for a moment and comes back
+    int reconnectTries = 0;
+
+    while (running)
+    {
+        int fd = connectUnixSocket(swaySocketPath());
+
+        if (fd < 0 && reconnectTries > 0)
+        {
+            reconnectTries--;
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            continue;
+        }
+
+        if (fd < 0) return;
+
+        uint32_t type = 0;
+        std::string payload;
+
+        if (!sendMessage(fd, (uint32_t)SwayMessage::SUBSCRIBE, "[\"window\",\"workspace\",\"output\",\"shutdown\"]") || !readMessage(fd, type, payload)
+            || !parseJson(payload)["success"].asBool())
+        {
+            close(fd);
+            return;
+        }
+
+        // GET_TREE once per connection, afterwards only deltas
+        SwayWatchState state;
+        state.load();
+        onChange(state.instances);
+        bool geometrySynced = false;
+
+        bool exiting = false;
+
+        while (running)
+        {
+            // intellihide may start wanting geometry after the connection was made (backends start before the window)
+            if (!geometrySynced && windowGeometryWanted())
+            {
+                swaySyncGeometry();
+                geometrySynced = true;
+            }
+
+            pollfd pfd = { fd, POLLIN, 0 };
+            int r = poll(&pfd, 1, 500);
+
+            if (r < 0 && errno == EINTR) continue;
+            if (r < 0) break;
+            if (r == 0) continue;   // timeout, recheck running
+
+            if (!readMessage(fd, type, payload)) break;
+
+            bool changed = false;
+            bool moved = false;
+
+            if (type == SWAY_EVENT_WINDOW)
+            {
+                JsonValue ev = parseJson(payload);
+                std::string change = ev["change"].asString();
+
+                changed = state.apply(ev);
+                moved = change != "title" && change != "mark" && change != "urgent";
+            } else if (type == SWAY_EVENT_WORKSPACE)
+            {
+                // another workspace got shown, only changes which windows are on screen
+                if (state.applyWorkspace(parseJson(payload)))
+                {
+                    state.load();
+                    changed = true;
+                }
+
+                moved = true;
+            } else if (type == SWAY_EVENT_OUTPUT)
+            {
+                // outputs got added / removed, monitor indices may have shifted
+                state.load();
+                changed = true;
+                moved = true;
+            } else if (type == SWAY_EVENT_SHUTDOWN)
+            {
+                // "restart" (i3) comes back on the same socket, only "exit" ends the session
+                exiting = parseJson(payload)["change"].asString() != "restart";
+                reconnectTries = exiting ? 0 : 40;
+                break;
+            }
+
+            if (changed) onChange(state.instances);
+            if (moved && windowGeometryWanted()) swaySyncGeometry();
+        }
+
+        close(fd);
+
+        if (exiting) return;
+        if (running) std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+}
+
+/*
+    built in gtkdock_backend
+*/
+
+static std::atomic<bool> swayWatching(false);
+
+static int swayProbe()
+{
+    return swayIpcAvailable();
+}
+
+static void swayEnumerate(gtkdock_instances_cb cb, void * user_data)
+{
+    emitInstances(swayGetWindows(), cb, user_data);
+}
+
+static int swaySubscribe(gtkdock_instances_cb cb, void * user_data)
+{
+    runWatcherThread(swayWatching, swayWatchInstances, swayGetWindows, cb, user_data);
+    return 0;
+}
+
+static void swayUnsubscribe()
+{
+    swayWatching = false;
+}
+
+static void swayActivate(const char * id)
+{
+    swayRunCommand(std::string("[con_id=") + id + "] focus");
+}
+
+static void swayClose(const char * const * ids, size_t count)
+{
+    std::string commands = "";
+    for (size_t i = 0; i < count; i++)
+        commands += std::string("[con_id=") + ids[i] + "] kill;";
+
+    swayRunCommand(commands);
+}
+
+static size_t swayMenuActions(const gtkdock_instance *, gtkdock_menu_action * actions, size_t max)
+{
+    static const gtkdock_menu_action swayActions[] = {
+        { "Toggle Fullscreen", "fullscreen" },
+        { "Toggle Floating", "floating" }
+    };
+
+    size_t n = std::min(max, sizeof(swayActions) / sizeof(swayActions[0]));
+    for (size_t i = 0; i < n; i++)
+        actions[i] = swayActions[i];
+
+    return n;
+}
+
+static void swayRunMenuAction(const char * id, const char * action)
+{
+    swayRunCommand(std::string("[con_id=") + id + "] " + action + " toggle");
+}
+
+static const gtkdock_backend sway = {
+    GTKDOCK_BACKEND_ABI_VERSION,
+    "sway",
+    swayProbe,
+    swayEnumerate,
+    swaySubscribe,
+    swayUnsubscribe,
+    swayActivate,
+    swayClose,
+    swayMenuActions,
+    swayRunMenuAction
+};
+
+const gtkdock_backend * swayBackend()
+{
+    return &sway;
+}
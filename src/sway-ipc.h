@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include "utils.h"
+#include "dock-backend.h"
+
+/*
+    in-process sway / i3 backend
+    talks the i3-ipc protocol over $SWAYSOCK (or $I3SOCK): GET_TREE / GET_WORKSPACES once, then SUBSCRIBE ["window","workspace","output","shutdown"]
+    window events are applied to the list, their output comes from the workspaces, the tree is only fetched again when outputs change or a workspace moves to another output
+    windows are addressed by con_id so titles with quotes etc. don't matter
+*/
+
+enum class SwayMessage : uint32_t
+{
+    RUN_COMMAND = 0,
+    GET_WORKSPACES = 1,
+    SUBSCRIBE = 2,
+    GET_OUTPUTS = 3,
+    GET_TREE = 4
+};
+
+// true if SWAYSOCK / I3SOCK points to an existing socket
+bool swayIpcAvailable();
+
+// sends one message and returns the payload of the reply ("" on failure)
+std::string swayRequest(SwayMessage type, const std::string& payload);
+
+// runs a sway command ex. "[con_id=12] focus"
+void swayRunCommand(const std::string& command);
+
+// walks GET_TREE and converts every view to an AppInstance (id is the con_id)
+std::vector<AppInstance> swayGetWindows();
+
+// blocks on a subscribed connection keeping an instance list that is updated from window/output events
+// onChange gets called with the full list whenever it changed
+// also keeps window-geometry.h up to date while it is wanted (intellihide)
+// returns once running is false, sway / i3 exits (an i3 restart reconnects) or the socket can't be (re)connected
+void swayWatchInstances(std::atomic<bool>& running, const std::function<void(const std::vector<AppInstance>&)>& onChange);
+
+// the above as a gtkdock_backend (see backend.h)
+const gtkdock_backend * swayBackend();
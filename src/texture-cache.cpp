@@ -0,0 +1,131 @@
+#include "texture-cache.h"
+#include <unordered_map>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <iostream>
+#include <algorithm>
+
+static const unsigned MAX_WORKERS = 4;
+
+struct CachedTexture
+{
+    Glib::RefPtr<Gdk::Texture> texture;
+    bool ready = false;
+};
+
+/*
+    cache / queue: guarded by cacheMutex, workers take keys from the queue and fill in the entries
+    readyDispatcher wakes the main thread, it only re-emits readySignal so listeners run there
+*/
+
+static std::mutex cacheMutex;
+static std::condition_variable queueCond;
+static std::unordered_map<std::string, CachedTexture> cache = {};
+static std::deque<std::string> queue = {};
+static unsigned workers = 0;
+
+static Glib::Dispatcher * readyDispatcher = nullptr;
+static sigc::signal<void()> readySignal;
+
+// "px@scale:path", the path goes last so it can be split off again
+static std::string cacheKey(const std::string& path, int px, int scale)
+{
+    return std::to_string(px) + "@" + std::to_string(scale) + ":" + path;
+}
+
+static void decode(const std::string& key)
+{
+    size_t at = key.find('@');
+    size_t colon = key.find(':');
+    int px = std::stoi(key.substr(0, at));
+    int scale = std::stoi(key.substr(at + 1, colon - at - 1));
+    std::string path = key.substr(colon + 1);
+
+    Glib::RefPtr<Gdk::Texture> tex;
+
+    try
+    {
+        tex = Gdk::Texture::create_for_pixbuf(Gdk::Pixbuf::create_from_file(path, px * scale, px * scale, true));
+    } catch (const Glib::Error&)
+    {
+        std::cerr << "texture cache: can't load icon " << path << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        cache[key] = { tex, true };
+    }
+
+    readyDispatcher->emit();
+}
+
+static void workerLoop()
+{
+    while (true)
+    {
+        std::string key;
+
+        {
+            std::unique_lock<std::mutex> lock(cacheMutex);
+            queueCond.wait(lock, []() { return !queue.empty(); });
+
+            key = queue.front();
+            queue.pop_front();
+        }
+
+        decode(key);
+    }
+}
+
+Glib::RefPtr<Gdk::Texture> textureCacheGet(const std::string& path, int px, int scale, bool& ready)
+{
+    std::string key = cacheKey(path, px, scale);
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    auto it = cache.find(key);
+    if (it != cache.end())
+    {
+        ready = it->second.ready;
+        return it->second.texture;
+    }
+
+    // Dispatcher has to be created on the thread whose main loop runs the handler
+    if (readyDispatcher == nullptr)
+    {
+        readyDispatcher = new Glib::Dispatcher();
+        readyDispatcher->connect([]() { readySignal.emit(); });
+    }
+
+    cache[key] = {};
+    queue.push_back(key);
+
+    // one more worker per queued decode up to MAX_WORKERS, a cold dock decodes in parallel
+    if (workers < std::min(MAX_WORKERS, std::max(std::thread::hardware_concurrency(), 1u)))
+    {
+        workers++;
+        std::thread(workerLoop).detach();
+    }
+
+    queueCond.notify_one();
+
+    ready = false;
+    return {};
+}
+
+sigc::signal<void()>& textureCacheReady()
+{
+    return readySignal;
+}
+
+void textureCacheTrim()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    for (auto it = cache.begin(); it != cache.end();)
+    {
+        if (it->second.ready && it->second.texture && it->second.texture.use_count() == 1) it = cache.erase(it);
+        else it++;
+    }
+}
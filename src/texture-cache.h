@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+#include <gtkmm-4.0/gtkmm.h>
+
+/*
+    texture cache: decoded icons shared by everything that draws them, keyed by (path, px size, scale factor)
+    misses get decoded (png) / rasterized (svg) on a small pool of worker threads, never on the gtk main thread,
+    until then the caller draws a placeholder, textureCacheReady() fires on the main thread once textures arrived
+    a texture stays cached while someone holds a reference to it, textureCacheTrim() drops the rest
+*/
+
+// decoded px * scale device pixels, nullptr while it is still decoding (ready = false) or if it can't be read (ready = true)
+// has to be called from the main thread
+Glib::RefPtr<Gdk::Texture> textureCacheGet(const std::string& path, int px, int scale, bool& ready);
+
+// emitted on the main thread after one or more requested textures got decoded
+sigc::signal<void()>& textureCacheReady();
+
+// drops the textures nobody outside the cache references anymore (failed paths stay remembered)
+void textureCacheTrim();
@@ -1,6 +1,13 @@
 #include "utils.h"
+#include "backend.h"
+#include "desktop-index.h"
+#include "icon-index.h"
 #include <string>
 #include <unordered_map>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <charconv>
 
 std::string getRes(std::string file)
 {
@@ -74,13 +81,18 @@ std::vector<DesktopEntry> findDesktopFiles() {
 
     for (const auto& path : searchPaths) {
         if (std::filesystem::exists(path)) {
+            // sorted so matching doesn't depend on directory order
+            std::vector<std::filesystem::path> files = {};
             for (const auto& entry : std::filesystem::directory_iterator(path)) {
-                if (entry.path().extension() == ".desktop") 
-                {
-                    auto t = parseDesktopFile(entry.path());
-                    if (t.desktopFile != "")
-                        desktopFiles.push_back(t);
-                }
+                if (entry.path().extension() == ".desktop") files.push_back(entry.path());
+            }
+            std::sort(files.begin(), files.end());
+
+            for (const auto& file : files)
+            {
+                auto t = parseDesktopFile(file);
+                if (t.desktopFile != "")
+                    desktopFiles.push_back(t);
             }
         }
     }
@@ -112,62 +124,13 @@ std::string cleanExecCommand(const std::string& cmd) {
 
 std::string findIconPath(const std::string& iconName)
 {
-    auto iconTheme = Gtk::IconTheme::get_for_display(Gdk::Display::get_default());
-    auto iconInfo = iconTheme->lookup_icon(iconName, 48);
-    auto ret = iconInfo->get_file()->get_path();
-
-    if (std::filesystem::exists(ret))
-        return ret;
-
-    // Fallback to common paths
-    std::vector<std::string> extensions = {".svg", ".png",".xpm"};
-
+    if (!iconName.empty() && iconName[0] == '/')
     {
-        auto hits = splitStr(exec("plocate " + iconName), "\n");
-        
-        std::vector<std::string> besthits(extensions.size());;
-        
-        for (auto& hit : hits)
-        {
-            for (int i = 0; i < extensions.size(); i++)
-            {
-                if (std::filesystem::path(hit).extension() == extensions[i])
-                    besthits[i] = hit;
-            }
-        }
-
-        for (auto& hit : besthits)
-        {
-            if (std::filesystem::exists(hit))
-                return hit;
-        }
-    }
-
-    std::vector<std::filesystem::path> searchPaths = {
-        "/usr/share/pixmaps",
-        "/usr/share/icons/hicolor/48x48/apps",
-        "/usr/share/icons/hicolor/scalable/apps",
-        "/usr/share/icons/Adwaita/48x48/apps",
-        "/usr/share/icons",
-        "/usr/share/icons/Adwaita/symbolic/devices",
-        "/usr/share/icons/breeze-dark/actions/24",
-        "/usr/share/icons/breeze-dark/status/24"
-    };
-
-    for (const auto& path : searchPaths) {
-        if (!std::filesystem::exists(path)) continue;
-
-        for (const auto& ext : extensions) {
-            std::filesystem::path iconPath = path / (iconName + ext);
-            if (std::filesystem::exists(iconPath)) {
-                return iconPath.string();
-            }
-        }
-    }
-    
-
-    if (std::filesystem::exists(iconName) && iconName != "" && iconName[0] == '/') {
-        return iconName;
+        if (std::filesystem::exists(iconName)) return iconName;
+    } else
+    {
+        std::string path = iconIndexLookup(iconName);
+        if (!path.empty()) return path;
     }
 
     std::cout << "Couldn't find: " << iconName << std::endl;
@@ -208,6 +171,10 @@ DesktopEntry parseDesktopFile(const std::filesystem::path& desktopFile) {
         } else if (key == "Icon") {
             entry.iconPath = findIconPath(value);
             //std::cout << entry.name << " Found: " << entry.iconPath << std::endl;
+        } else if (key == "StartupWMClass") {
+            entry.startupWMClass = value;
+        } else if (key == "X-Flatpak") {
+            entry.flatpakId = value;
         } else if (key == "NoDisplay")
         {
             if (value.find("true") != std::string::npos)
@@ -229,8 +196,10 @@ std::string exec(const std::string& command)
         return "popen failed!";
     }
     try {
-        while (fgets(buffer, sizeof(buffer), pipe) != NULL) {
-            result += buffer;
+        // fread instead of fgets, output may contain NUL separated records
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+            result.append(buffer, n);
         }
     } catch (...) {
         pclose(pipe);
@@ -243,8 +212,121 @@ std::string exec(const std::string& command)
     return result;
 }
 
+int connectUnixSocket(const std::string& path)
+{
+    sockaddr_un addr = {};
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return -1;
+
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+// never throws unlike std::stoi, garbage gives def
+static int parseInt(std::string_view s, int def)
+{
+    int value = def;
+    if (std::from_chars(s.data(), s.data() + s.size(), value).ec != std::errc()) return def;
+    return value;
+}
+
+std::string instanceKey(const AppInstance& inst)
+{
+    return inst.id.empty() ? inst.title : inst.id;
+}
+
+bool identicalInstances(const std::vector<AppInstance>& a, const std::vector<AppInstance>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const AppInstance& x, const AppInstance& y) {
+        return x.id == y.id && x.monitorIdx == y.monitorIdx && x.title == y.title && x.wclass == y.wclass && x.fullscreen == y.fullscreen && x.pid == y.pid;
+    });
+}
+
+bool sameInstances(const std::vector<AppInstance>& a, const std::vector<AppInstance>& b)
+{
+    if (a.size() != b.size()) return false;
+
+    std::unordered_map<std::string, const AppInstance *> byKey = {};
+    for (const AppInstance& i : a)
+        byKey[instanceKey(i)] = &i;
+
+    for (const AppInstance& i : b)
+    {
+        auto it = byKey.find(instanceKey(i));
+        if (it == byKey.end() || it->second->title != i.title || it->second->fullscreen != i.fullscreen) return false;
+    }
+
+    return true;
+}
+
+AppInstance parseInstanceRecord(const std::string& record)
+{
+    std::vector<std::string> s = splitStr(record, "-:-");
+    s.resize(5);
+
+    for (int i = 0; i < s.size(); i++)
+    {
+        if (s[i].empty())
+        {
+            if (i == 0 || i == 3 || i == 4)
+            {
+                s[i] = "0";
+            } else
+            {
+                s[i] = "-";
+            }
+        }
+    }
+    
+    return { parseInt(s[0], 0), s[1], s[2], parseInt(s[3], 0) != 0, parseInt(s[4], 0) };
+}
+
+bool readRecordField(std::string_view data, size_t& pos, std::string_view& out)
+{
+    size_t end = data.find('\0', pos);
+    if (end == std::string_view::npos) return false;
+
+    out = data.substr(pos, end - pos);
+    pos = end + 1;
+    return true;
+}
+
+bool readInstanceRecord(std::string_view data, size_t& pos, AppInstance& out)
+{
+    std::string_view f[6];
+    size_t p = pos;
+
+    for (std::string_view& field : f)
+    {
+        if (!readRecordField(data, p, field)) return false;
+    }
+
+    out.id = f[0];
+    out.monitorIdx = parseInt(f[1], 0);
+    out.title = f[2].empty() ? "-" : f[2];
+    out.wclass = f[3].empty() ? "-" : f[3];
+    out.fullscreen = f[4] == "true" || parseInt(f[4], 0) != 0;
+    out.pid = parseInt(f[5], -1);
+
+    pos = p;
+    return true;
+}
+
 std::vector<AppInstance> getRunningInstances()
 {
+    // no need to fork bash / hyprctl / jq if we can ask the compositor directly
+    if (activeBackend() != nullptr) return backendEnumerate();
+
     std::vector<AppInstance> inst = {};
     
     std::string resp = exec("bash "+ getRes("conf/list_windows.bash"));
@@ -255,26 +337,21 @@ std::vector<AppInstance> getRunningInstances()
         return inst;
     }
 
-    for (auto& line : splitStr(resp, "\n"))
+    if (resp.find('\0') != std::string::npos)
     {
-        std::vector<std::string> s = splitStr(line, "-:-");
-        for (int i = 0; i < s.size(); i++)
-        {
-            if (s[i].empty())
-            {
-                if (i == 0 || i == 3 || i == 4)
-                {
-                    s[i] = "0";
-                } else
-                {
-                    s[i] = "-";
-                }
-            }
-        }
-        
-        inst.push_back( { std::stoi(s[0]), s[1], s[2], (bool)std::stoi(s[3]), std::stoi(s[4]) } );
+        size_t pos = 0;
+        AppInstance i;
+
+        while (readInstanceRecord(resp, pos, i))
+            inst.push_back(i);
+
+        return inst;
     }
 
+    // old scripts: one "-:-" separated line per window, no ids
+    for (auto& line : splitStr(resp, "\n"))
+        inst.push_back(parseInstanceRecord(line));
+
     return inst;
 }
 
@@ -309,81 +386,10 @@ bool find_case_insensitive(const std::string& str, const std::string& substr) {
     return (lower_str.find(lower_sub) != std::string::npos);
 }
 
-DesktopEntry getEntryOfInstances(const std::vector<AppInstance>& instances, std::vector<DesktopEntry> DesktopFiles)
+DesktopEntry getEntryOfInstances(const std::vector<AppInstance>& instances, const DesktopIndex& index)
 {
-    std::string wclass = instances[0].wclass;
-    std::string title = instances[0].title;
-
-    std::vector <std::string> lastFiles = {};
-
-    for (auto& dE : DesktopFiles)
-    {
-        if (find_case_insensitive(dE.desktopFile, wclass))
-            return dE;
-
-        if (find_case_insensitive(dE.name, wclass))
-            return dE;
-        
-        if (find_case_insensitive(dE.desktopFile, title))
-            return dE;
-
-        if (find_case_insensitive(dE.name, title))
-            return dE;
-    }
-
-    // last attempt
-    std::vector<std::string> searchTerms = {};
-
-    std::vector<std::string> temp =  splitStr(wclass, " ");
-    searchTerms.insert(searchTerms.end(), temp.begin(), temp.end());
-
-    temp =  splitStr(wclass, ".");
-    searchTerms.insert(searchTerms.end(), temp.begin(), temp.end());
-
-    temp =  splitStr(wclass, "-");
-    searchTerms.insert(searchTerms.end(), temp.begin(), temp.end());
-
-    temp =  splitStr(title, " ");
-    searchTerms.insert(searchTerms.end(), temp.begin(), temp.end());
-
-    temp =  splitStr(title, ".");
-    searchTerms.insert(searchTerms.end(), temp.begin(), temp.end());
-
-    temp =  splitStr(title, "-");
-    searchTerms.insert(searchTerms.end(), temp.begin(), temp.end());
-
-    std::unordered_map<std::string, int> hits = {};
-
-    for (std::string& term : searchTerms)
-    {
-        std::vector <std::string> hitFiles = splitStr(exec("plocate " + term + " | grep --color=never \"\\.desktop\""), "\n");
-        for (std::string& file : hitFiles)
-        {
-            if (!hits.contains(file))
-                hits[file] = 0;
-
-            hits[file] += 1;
-        }
-    }
-
-    if (hits.size() > 0)
-    {
-        int score = 0;
-        std::string file = "";
-
-        for (auto& pair : hits)
-        {
-            if (pair.second > score)
-            {
-                file = pair.first;
-                score = pair.second;
-            }
-        }
-
-        return parseDesktopFile(file);
-    }
-
-    return DesktopEntry();
+    int i = index.match(instances[0].wclass, instances[0].title);
+    return (i >= 0) ? index.entries[i] : DesktopEntry();
 }
 
 bool getIfThisIsOnlyInstance()
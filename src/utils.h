@@ -15,6 +15,7 @@
 #include <thread>
 #include <filesystem>
 #include <memory>
+#include <string_view>
 
 #include <gtkmm-4.0/gtkmm.h>
 
@@ -25,14 +26,26 @@ struct AppInstance
     std::string wclass = "";
     bool fullscreen = false;
     int pid = -1;
+    std::string id = "";    // window id given by the backend (hyprland: address), empty if unknown
 };
 
+// key instances get compared by: the window id, the title for old list_windows.bash output without ids
+std::string instanceKey(const AppInstance& inst);
+
+// true if both lists are equal field by field in the same order
+bool identicalInstances(const std::vector<AppInstance>& a, const std::vector<AppInstance>& b);
+
+// true if both lists hold the same windows (by instanceKey, order doesn't matter) with the same title / fullscreen state
+bool sameInstances(const std::vector<AppInstance>& a, const std::vector<AppInstance>& b);
+
 struct DesktopEntry
 {
     std::string name = "";
     std::string execCmd = "";
     std::string iconPath = "";
     std::string desktopFile = "";
+    std::string startupWMClass = "";
+    std::string flatpakId = "";     // X-Flatpak
 
     bool operator==(DesktopEntry& other) const {
         return (name == other.name && execCmd == other.execCmd);
@@ -45,6 +58,8 @@ struct AppEntry
     bool isPinned = false;
     DesktopEntry app;
     std::vector <AppInstance> instances = {};
+    std::string key = "";       // stable identity: desktop file, "class:<wclass>" if unresolved, "line" / "launcher"
+    uint64_t generation = 0;    // changes whenever anything shown for this entry changes (see entry-model.h)
 };
 
 enum class DockEdge
@@ -86,16 +101,34 @@ DesktopEntry parseDesktopFile(const std::filesystem::path& desktopFile);
 
 std::string exec(const std::string& command);
 
+// connects to a unix stream socket, returns fd or -1
+int connectUnixSocket(const std::string& path);
+
+// parses one "monitorIdx-:-title-:-class-:-isFullscreen-:-PID" line of old list_windows.bash scripts
+AppInstance parseInstanceRecord(const std::string& record);
+
+// reads one "ID\0monitorIdx\0title\0class\0isFullscreen\0PID\0" record starting at pos and moves pos behind it
+// returns false (pos untouched) if data ends before the record is complete
+bool readInstanceRecord(std::string_view data, size_t& pos, AppInstance& out);
+
+// reads the NUL terminated field starting at pos, false if there is no terminating NUL yet
+bool readRecordField(std::string_view data, size_t& pos, std::string_view& out);
+
 // parses result of list_windows.bash into vector of AppInstance
 std::vector<AppInstance> getRunningInstances();
 
+// to_lower + only alphanumeric chars ex. "SomeVery-weirdApP-name" --> "someveryweirdappname"
+std::string normalizeString(const std::string& input);
+
 // find if normalizeString(substr) is found in normalizeString(str)
 bool find_case_insensitive(const std::string& str, const std::string& substr);
 
 std::string getSmallestString(const std::vector<std::string>& strings);
 
-// finds .desktop file of instances using various heuristics
-DesktopEntry getEntryOfInstances(const std::vector<AppInstance>& instances, std::vector<DesktopEntry> DesktopFiles);
+struct DesktopIndex;
+
+// finds .desktop file of instances by ranking them in the desktop index (see desktop-index.h)
+DesktopEntry getEntryOfInstances(const std::vector<AppInstance>& instances, const DesktopIndex& index);
 
 bool getIfThisIsOnlyInstance();
 
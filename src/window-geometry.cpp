@@ -0,0 +1,188 @@
+#include "window-geometry.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <gtkmm-4.0/gtkmm.h>
+
+static const int GRID_CELL = 256;
+
+static std::mutex geometryMutex;
+static std::atomic<bool> wanted(false);
+static std::atomic<bool> available(false);
+static Glib::Dispatcher * changedDispatcher = nullptr;
+
+static std::unordered_map<std::string, WindowGeometry> windows = {};
+// (monitor, cell) -> ids of the windows covering the cell
+static std::unordered_map<uint64_t, std::unordered_set<std::string>> grid = {};
+
+bool WindowRect::intersects(const WindowRect& o) const
+{
+    return x < o.x + o.w && o.x < x + w && y < o.y + o.h && o.y < y + h;
+}
+
+bool WindowRect::operator==(const WindowRect& o) const
+{
+    return x == o.x && y == o.y && w == o.w && h == o.h;
+}
+
+static uint64_t cellKey(int monitorIdx, int cx, int cy)
+{
+    return ((uint64_t)(uint16_t)monitorIdx << 48) | ((uint64_t)(uint32_t)(cx & 0xffffff) << 24) | (uint64_t)(uint32_t)(cy & 0xffffff);
+}
+
+// floor division, windows can sit at negative coordinates
+static int cellOf(int v)
+{
+    return (v >= 0) ? v / GRID_CELL : -((-v + GRID_CELL - 1) / GRID_CELL);
+}
+
+template <typename F>
+static void forCells(int monitorIdx, const WindowRect& r, F f)
+{
+    if (r.w <= 0 || r.h <= 0) return;
+
+    for (int cx = cellOf(r.x); cx <= cellOf(r.x + r.w - 1); cx++)
+    {
+        for (int cy = cellOf(r.y); cy <= cellOf(r.y + r.h - 1); cy++)
+            f(cellKey(monitorIdx, cx, cy));
+    }
+}
+
+static void unindex(const WindowGeometry& g)
+{
+    forCells(g.monitorIdx, g.rect, [&g](uint64_t key) {
+        auto it = grid.find(key);
+        if (it == grid.end()) return;
+
+        it->second.erase(g.id);
+        if (it->second.empty()) grid.erase(it);
+    });
+}
+
+static void index(const WindowGeometry& g)
+{
+    forCells(g.monitorIdx, g.rect, [&g](uint64_t key) {
+        grid[key].insert(g.id);
+    });
+}
+
+// returns true if something changed, caller holds geometryMutex
+static bool updateLocked(const WindowGeometry& g)
+{
+    auto it = windows.find(g.id);
+
+    if (it != windows.end())
+    {
+        if (it->second.monitorIdx == g.monitorIdx && it->second.rect == g.rect) return false;
+        unindex(it->second);
+    }
+
+    windows[g.id] = g;
+    index(g);
+    return true;
+}
+
+static bool removeLocked(const std::string& id)
+{
+    auto it = windows.find(id);
+    if (it == windows.end()) return false;
+
+    unindex(it->second);
+    windows.erase(it);
+    return true;
+}
+
+static void notify(bool changed)
+{
+    available = true;
+    if (changed && changedDispatcher != nullptr) changedDispatcher->emit();
+}
+
+void windowGeometryWatch(const std::function<void()>& onChanged)
+{
+    // Dispatcher has to be created on the thread whose main loop runs the handler
+    changedDispatcher = new Glib::Dispatcher();
+    changedDispatcher->connect(onChanged);
+    wanted = true;
+}
+
+bool windowGeometryWanted()
+{
+    return wanted;
+}
+
+bool windowGeometryAvailable()
+{
+    return available;
+}
+
+void windowGeometryUpdate(const WindowGeometry& g)
+{
+    bool changed;
+    {
+        std::lock_guard<std::mutex> lock(geometryMutex);
+        changed = updateLocked(g);
+    }
+    notify(changed);
+}
+
+void windowGeometryRemove(const std::string& id)
+{
+    bool changed;
+    {
+        std::lock_guard<std::mutex> lock(geometryMutex);
+        changed = removeLocked(id);
+    }
+    notify(changed);
+}
+
+void windowGeometrySync(const std::vector<WindowGeometry>& list)
+{
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(geometryMutex);
+        std::unordered_set<std::string> ids = {};
+
+        for (const WindowGeometry& g : list)
+        {
+            ids.insert(g.id);
+            changed |= updateLocked(g);
+        }
+
+        std::vector<std::string> gone = {};
+        for (const auto& [id, g] : windows)
+        {
+            if (ids.count(id) == 0) gone.push_back(id);
+        }
+
+        for (const std::string& id : gone)
+            changed |= removeLocked(id);
+    }
+    notify(changed);
+}
+
+bool windowGeometryOverlaps(int monitorIdx, const WindowRect& rect)
+{
+    std::lock_guard<std::mutex> lock(geometryMutex);
+    bool hit = false;
+
+    forCells(monitorIdx, rect, [&](uint64_t key) {
+        if (hit) return;
+
+        auto it = grid.find(key);
+        if (it == grid.end()) return;
+
+        for (const std::string& id : it->second)
+        {
+            if (windows[id].rect.intersects(rect))
+            {
+                hit = true;
+                return;
+            }
+        }
+    });
+
+    return hit;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+
+/*
+    window geometry: rectangles of the windows that can currently be seen (mapped, on a shown workspace) in global layout coordinates
+    reported by the backends that know them (hyprland, sway, X11; wlr-foreign-toplevel has no geometry), used by intellihide
+
+    kept in a grid of GRID_CELL px cells per monitor, an update only touches the cells the old and new rectangle cover
+    and an overlap check only looks at the windows in the cells under the dock instead of at every window
+
+    backends report from their own threads, the ui gets woken through a Glib::Dispatcher
+*/
+
+struct WindowRect
+{
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+
+    bool intersects(const WindowRect& o) const;
+    bool operator==(const WindowRect& o) const;
+};
+
+struct WindowGeometry
+{
+    std::string id = "";        // AppInstance::id
+    int monitorIdx = 0;
+    WindowRect rect;
+};
+
+// starts collecting (backends skip all geometry work until then), onChanged runs on the main loop after changes
+// has to be called on the main thread
+void windowGeometryWatch(const std::function<void()>& onChanged);
+
+// true once windowGeometryWatch() ran, backends check this before fetching geometry
+bool windowGeometryWanted();
+
+// true once a backend reported anything, without it intellihide can't work
+bool windowGeometryAvailable();
+
+// window appeared / moved / got resized
+void windowGeometryUpdate(const WindowGeometry& g);
+
+// window closed / got hidden / its workspace isn't shown anymore
+void windowGeometryRemove(const std::string& id);
+
+// complete list from backends that re-read everything, windows missing from it get removed, unchanged ones aren't touched
+void windowGeometrySync(const std::vector<WindowGeometry>& windows);
+
+// does any window on monitorIdx intersect rect
+bool windowGeometryOverlaps(int monitorIdx, const WindowRect& rect);
@@ -1,4 +1,6 @@
 #include "wm-specific.h"
+#include "backend.h"
+#include "x11-ewmh.h"
 #include <gtk4-layer-shell.h>
 #include <gtkmm-4.0/gtkmm.h>
 
@@ -6,7 +8,8 @@ void check_layer_shell_support()
 {
     bool supported = gtk_layer_is_supported();
     
-    if(!supported)
+    // X11 has no layer shell, the dock gets placed as an EWMH dock window instead
+    if(!supported && !x11EwmhAvailable())
     {
         std::cout << "gtk-layer-shell protocol is not supported on your wayland WM" << std::endl;
         std::exit(0);
@@ -15,6 +18,12 @@ void check_layer_shell_support()
 
 void GLS_setup_top_layer(Gtk::Window * win, int dispIdx, int edgeMargin, const std::string& name, DockEdge edge, DockAlignment alignment, bool exclusive, int winW, int winH)
 {
+    if (!gtk_layer_is_supported())
+    {
+        x11SetupDockWindow(win, dispIdx, edgeMargin, edge, alignment, exclusive);
+        return;
+    }
+
     GtkLayerShellEdge ed = (edge == DockEdge::EDGELEFT) ? GTK_LAYER_SHELL_EDGE_LEFT : (edge == DockEdge::EDGETOP) ? GTK_LAYER_SHELL_EDGE_TOP : (edge == DockEdge::EDGERIGHT) ? GTK_LAYER_SHELL_EDGE_RIGHT : GTK_LAYER_SHELL_EDGE_BOTTOM;
 
     gtk_layer_init_for_window(GTK_WINDOW(win->gobj()));
@@ -43,16 +52,32 @@ void GLS_setup_top_layer(Gtk::Window * win, int dispIdx, int edgeMargin, const s
 
 void GLS_chngMargin(Gtk::Window * win, int newMargin, DockEdge edge)
 {
+    if (!gtk_layer_is_supported())
+    {
+        x11SetDockMargin(win, newMargin);
+        return;
+    }
+
     GtkLayerShellEdge ed = (edge == DockEdge::EDGELEFT) ? GTK_LAYER_SHELL_EDGE_LEFT : (edge == DockEdge::EDGETOP) ? GTK_LAYER_SHELL_EDGE_TOP : (edge == DockEdge::EDGERIGHT) ? GTK_LAYER_SHELL_EDGE_RIGHT : GTK_LAYER_SHELL_EDGE_BOTTOM;
     gtk_layer_set_margin(GTK_WINDOW(win->gobj()), ed, newMargin);
 }
 
+// X11 sessions may come without XDG_SESSION_TYPE (see check_wayland_support)
+static bool waylandSession()
+{
+    const char * session = std::getenv("XDG_SESSION_TYPE");
+    return session != NULL && strcmp(session, "wayland") == 0;
+}
+
 void openInstance(AppInstance i)
 {
-    if (std::getenv("HYPRLAND_INSTANCE_SIGNATURE") != NULL)
+    if (activeBackend() != nullptr && !i.id.empty())
+    {
+        backendActivate(i);
+    } else if (std::getenv("HYPRLAND_INSTANCE_SIGNATURE") != NULL)
     {
         std::system(((std::string)"ADDRESS=$(hyprctl -j clients | jq -r '.[] | select(.title == \"" + i.title + "\") | .address') && hyprctl dispatch focuswindow \"address:$ADDRESS\"").c_str());
-    } else if (!(strcmp(std::getenv("XDG_SESSION_TYPE"), "wayland") == 0))
+    } else if (!waylandSession())
     {
         std::system(("wmctrl -a \"" + i.title + "\"").c_str());
     }
@@ -60,7 +85,11 @@ void openInstance(AppInstance i)
 
 void closeInstance(std::vector<AppInstance> instances)
 {
-    if (std::getenv("HYPRLAND_INSTANCE_SIGNATURE") != NULL)
+    if (activeBackend() != nullptr && !instances.empty() && !instances[0].id.empty())
+    {
+        backendClose(instances);
+        return;
+    } else if (std::getenv("HYPRLAND_INSTANCE_SIGNATURE") != NULL)
     {
         if (instances.size() > 1)
         {
@@ -70,7 +99,7 @@ void closeInstance(std::vector<AppInstance> instances)
             std::system(((std::string)"hyprctl dispatch closewindow title:\"^(" + instances[0].title + ")$\" && sleep 0.01s").c_str());
         }
         return;
-    } else if (!(strcmp(std::getenv("XDG_SESSION_TYPE"), "wayland") == 0))
+    } else if (!waylandSession())
     {
         for (AppInstance& i : instances)
         {
@@ -81,7 +110,20 @@ void closeInstance(std::vector<AppInstance> instances)
 
 void populateInstanceMenuWithWMSpecific(Gtk::Box* popover_box, AppInstance inst)
 {
-    if (std::getenv("HYPRLAND_INSTANCE_SIGNATURE") != NULL)
+    if (activeBackend() != nullptr && !inst.id.empty())
+    {
+        for (const auto& action : backendMenuActions(inst))
+        {
+            auto button2 = Gtk::make_managed<Gtk::Button>(action.first);
+            
+            button2->signal_clicked().connect([inst, action](){
+                backendRunMenuAction(inst, action.second);
+            });
+
+            button2->add_css_class("mbutton");
+            popover_box->append(*button2);
+        }
+    } else if (std::getenv("HYPRLAND_INSTANCE_SIGNATURE") != NULL)
     {
         auto button2 = Gtk::make_managed<Gtk::Button>("Toggle Floating");
         
@@ -91,7 +133,7 @@ void populateInstanceMenuWithWMSpecific(Gtk::Box* popover_box, AppInstance inst)
 
         button2->add_css_class("mbutton");
         popover_box->append(*button2);
-    } else if(!(strcmp(std::getenv("XDG_SESSION_TYPE"), "wayland") == 0))
+    } else if(!waylandSession())
     {
         auto button2 = Gtk::make_managed<Gtk::Button>(inst.fullscreen ? "Minimize" : "Maximize");
         
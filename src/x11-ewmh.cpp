@@ -0,0 +1,648 @@
+#include "x11-ewmh.h"
+#include "backend.h"
+#include "window-geometry.h"
+#include <mutex>
+#include <poll.h>
+#include <cerrno>
+#include <gdk/x11/gdkx.h>
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+
+/*
+    gdk owns the main thread X connection, the watcher thread opens its own one
+    X errors (BadWindow when a client vanishes between events) are ignored on our connections only
+*/
+
+struct MonitorRect { int x, y, w, h; };
+
+static std::mutex monitorsMutex;
+static std::vector<MonitorRect> monitorRects = {};
+
+static std::mutex displaysMutex;
+static std::set<Display *> ownDisplays = {};
+static XErrorHandler previousErrorHandler = nullptr;
+static bool errorHandlerInstalled = false;
+
+struct X11Atoms
+{
+    Atom clientList, utf8String, netWmName, netWmState, netWmStateFullscreen, netWmStateMaxVert, netWmStateMaxHorz, netWmStateAbove, netWmStateSticky, netWmStateHidden,
+         netWmPid, netActiveWindow, netCloseWindow, netWmWindowType, netWmWindowTypeDock, netWmDesktop, netWmStrut;
+
+    explicit X11Atoms(Display * dpy)
+    {
+        clientList = XInternAtom(dpy, "_NET_CLIENT_LIST", False);
+        utf8String = XInternAtom(dpy, "UTF8_STRING", False);
+        netWmName = XInternAtom(dpy, "_NET_WM_NAME", False);
+        netWmState = XInternAtom(dpy, "_NET_WM_STATE", False);
+        netWmStateFullscreen = XInternAtom(dpy, "_NET_WM_STATE_FULLSCREEN", False);
+        netWmStateMaxVert = XInternAtom(dpy, "_NET_WM_STATE_MAXIMIZED_VERT", False);
+        netWmStateMaxHorz = XInternAtom(dpy, "_NET_WM_STATE_MAXIMIZED_HORZ", False);
+        netWmStateAbove = XInternAtom(dpy, "_NET_WM_STATE_ABOVE", False);
+        netWmStateSticky = XInternAtom(dpy, "_NET_WM_STATE_STICKY", False);
+        netWmStateHidden = XInternAtom(dpy, "_NET_WM_STATE_HIDDEN", False);
+        netWmPid = XInternAtom(dpy, "_NET_WM_PID", False);
+        netActiveWindow = XInternAtom(dpy, "_NET_ACTIVE_WINDOW", False);
+        netCloseWindow = XInternAtom(dpy, "_NET_CLOSE_WINDOW", False);
+        netWmWindowType = XInternAtom(dpy, "_NET_WM_WINDOW_TYPE", False);
+        netWmWindowTypeDock = XInternAtom(dpy, "_NET_WM_WINDOW_TYPE_DOCK", False);
+        netWmDesktop = XInternAtom(dpy, "_NET_WM_DESKTOP", False);
+        netWmStrut = XInternAtom(dpy, "_NET_WM_STRUT", False);
+    }
+};
+
+static int ignoreOwnErrors(Display * dpy, XErrorEvent * ev)
+{
+    {
+        std::lock_guard<std::mutex> lock(displaysMutex);
+        if (ownDisplays.contains(dpy)) return 0;
+    }
+
+    return (previousErrorHandler != nullptr) ? previousErrorHandler(dpy, ev) : 0;
+}
+
+// opens a private connection, chains the error handler the first time (has to happen after gdk installed its own)
+static Display * openDisplay()
+{
+    Display * dpy = XOpenDisplay(NULL);
+    if (dpy == NULL) return NULL;
+
+    std::lock_guard<std::mutex> lock(displaysMutex);
+    if (!errorHandlerInstalled)
+    {
+        previousErrorHandler = XSetErrorHandler(ignoreOwnErrors);
+        errorHandlerInstalled = true;
+    }
+
+    ownDisplays.insert(dpy);
+    return dpy;
+}
+
+static void closeDisplay(Display * dpy)
+{
+    {
+        std::lock_guard<std::mutex> lock(displaysMutex);
+        ownDisplays.erase(dpy);
+    }
+
+    XCloseDisplay(dpy);
+}
+
+// main thread connection shared with gdk
+static Display * gdkXDisplay()
+{
+    GdkDisplay * display = Gdk::Display::get_default()->gobj();
+    if (!GDK_IS_X11_DISPLAY(display)) return NULL;
+    return gdk_x11_display_get_xdisplay(display);
+}
+
+static std::vector<unsigned long> getWindowList(Display * dpy, Window w, Atom prop, Atom type)
+{
+    std::vector<unsigned long> res = {};
+    Atom actualType;
+    int format;
+    unsigned long n, after;
+    unsigned char * data = nullptr;
+
+    if (XGetWindowProperty(dpy, w, prop, 0, 4096, False, type, &actualType, &format, &n, &after, &data) == Success && data != nullptr)
+    {
+        // format 32 properties are returned as longs
+        if (format == 32)
+        {
+            unsigned long * values = reinterpret_cast<unsigned long *>(data);
+            res.assign(values, values + n);
+        }
+        XFree(data);
+    }
+
+    return res;
+}
+
+static std::string getWindowTitle(Display * dpy, const X11Atoms& a, Window w)
+{
+    std::string title = "";
+    Atom actualType;
+    int format;
+    unsigned long n, after;
+    unsigned char * data = nullptr;
+
+    if (XGetWindowProperty(dpy, w, a.netWmName, 0, 1024, False, a.utf8String, &actualType, &format, &n, &after, &data) == Success && data != nullptr)
+    {
+        title.assign(reinterpret_cast<char *>(data), n);
+        XFree(data);
+    }
+
+    if (title.empty())
+    {
+        char * name = nullptr;
+        if (XFetchName(dpy, w, &name) && name != nullptr)
+        {
+            title = name;
+            XFree(name);
+        }
+    }
+
+    return title;
+}
+
+static int monitorIdxAt(int x, int y)
+{
+    std::lock_guard<std::mutex> lock(monitorsMutex);
+
+    for (size_t i = 0; i < monitorRects.size(); i++)
+    {
+        const MonitorRect& m = monitorRects[i];
+        if (x >= m.x && x < m.x + m.w && y >= m.y && y < m.y + m.h) return i;
+    }
+
+    return 0;
+}
+
+static int monitorIdxOfWindow(Display * dpy, Window w)
+{
+    Window root, child;
+    int x, y, rx, ry;
+    unsigned int width, height, border, depth;
+
+    if (!XGetGeometry(dpy, w, &root, &x, &y, &width, &height, &border, &depth)) return 0;
+    if (!XTranslateCoordinates(dpy, w, root, 0, 0, &rx, &ry, &child)) return 0;
+
+    return monitorIdxAt(rx + width / 2, ry + height / 2);
+}
+
+static std::string windowId(Window w)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "0x%lx", w);
+    return buf;
+}
+
+static Window parseWindowId(const std::string& id)
+{
+    return std::strtoul(id.c_str(), nullptr, 0);
+}
+
+static AppInstance readWindow(Display * dpy, const X11Atoms& a, Window w)
+{
+    AppInstance i;
+    i.id = windowId(w);
+    i.title = getWindowTitle(dpy, a, w);
+    i.monitorIdx = monitorIdxOfWindow(dpy, w);
+
+    XClassHint hint = { nullptr, nullptr };
+    if (XGetClassHint(dpy, w, &hint))
+    {
+        if (hint.res_class != nullptr) i.wclass = hint.res_class;
+        if (hint.res_name != nullptr) XFree(hint.res_name);
+        if (hint.res_class != nullptr) XFree(hint.res_class);
+    }
+
+    for (unsigned long s : getWindowList(dpy, w, a.netWmState, XA_ATOM))
+    {
+        if (s == a.netWmStateFullscreen) i.fullscreen = true;
+    }
+
+    auto pid = getWindowList(dpy, w, a.netWmPid, XA_CARDINAL);
+    if (!pid.empty()) i.pid = pid[0];
+
+    if (i.title.empty()) i.title = "-";
+    if (i.wclass.empty()) i.wclass = "-";
+
+    return i;
+}
+
+// root coordinates of w, false if it isn't on screen (unmapped: other desktop, hidden: minimized)
+static bool readGeometry(Display * dpy, const X11Atoms& a, Window w, WindowGeometry& g)
+{
+    XWindowAttributes attr;
+    if (!XGetWindowAttributes(dpy, w, &attr) || attr.map_state != IsViewable) return false;
+
+    for (unsigned long s : getWindowList(dpy, w, a.netWmState, XA_ATOM))
+    {
+        if (s == a.netWmStateHidden) return false;
+    }
+
+    Window child;
+    int rx, ry;
+    if (!XTranslateCoordinates(dpy, w, attr.root, 0, 0, &rx, &ry, &child)) return false;
+
+    g.id = windowId(w);
+    g.rect = { rx, ry, attr.width, attr.height };
+    g.monitorIdx = monitorIdxAt(rx + attr.width / 2, ry + attr.height / 2);
+    return true;
+}
+
+bool x11EwmhAvailable()
+{
+    static int available = -1;
+    if (available != -1) return available;
+
+    available = 0;
+    const char * session = std::getenv("XDG_SESSION_TYPE");
+    if (std::getenv("DISPLAY") == NULL || (session != NULL && strcmp(session, "wayland") == 0)) return false;
+
+    // runs before gtk is initialized so don't touch the error handler here
+    Display * dpy = XOpenDisplay(NULL);
+    if (dpy == NULL) return false;
+
+    Atom supported = XInternAtom(dpy, "_NET_SUPPORTED", False);
+    Atom clientList = XInternAtom(dpy, "_NET_CLIENT_LIST", False);
+
+    for (unsigned long atom : getWindowList(dpy, DefaultRootWindow(dpy), supported, XA_ATOM))
+    {
+        if (atom == clientList) available = 1;
+    }
+
+    XCloseDisplay(dpy);
+    return available;
+}
+
+void x11CacheMonitorGeometry()
+{
+    auto monitors = Gdk::Display::get_default()->get_monitors();
+    std::vector<MonitorRect> rects = {};
+
+    for (guint i = 0; i < monitors->get_n_items(); i++)
+    {
+        GdkRectangle g;
+        gdk_monitor_get_geometry(GDK_MONITOR(monitors->get_object(i)->gobj()), &g);
+        rects.push_back({ g.x, g.y, g.width, g.height });
+    }
+
+    std::lock_guard<std::mutex> lock(monitorsMutex);
+    monitorRects = rects;
+}
+
+std::vector<AppInstance> x11GetWindows()
+{
+    std::vector<AppInstance> inst = {};
+    Display * dpy = openDisplay();
+    if (dpy == NULL) return inst;
+
+    X11Atoms a(dpy);
+
+    for (unsigned long w : getWindowList(dpy, DefaultRootWindow(dpy), a.clientList, XA_WINDOW))
+        inst.push_back(readWindow(dpy, a, w));
+
+    closeDisplay(dpy);
+    return inst;
+}
+
+void x11WatchInstances(std::atomic<bool>& running, const std::function<void(const std::vector<AppInstance>&)>& onChange)
+{
+    Display * dpy = openDisplay();
+    if (dpy == NULL) return;
+
+    X11Atoms a(dpy);
+    Window root = DefaultRootWindow(dpy);
+    std::vector<AppInstance> instances = {};
+
+    XSelectInput(dpy, root, PropertyChangeMask);
+
+    // rebuilds the list in _NET_CLIENT_LIST order, only new clients get their properties read
+    auto syncClientList = [&]() {
+        std::vector<AppInstance> next = {};
+        bool changed = false;
+
+        for (unsigned long w : getWindowList(dpy, root, a.clientList, XA_WINDOW))
+        {
+            std::string id = windowId(w);
+            auto it = std::find_if(instances.begin(), instances.end(), [&id](const AppInstance& i) { return i.id == id; });
+
+            if (it != instances.end())
+            {
+                next.push_back(*it);
+            } else
+            {
+                XSelectInput(dpy, w, PropertyChangeMask | StructureNotifyMask);
+                next.push_back(readWindow(dpy, a, w));
+                changed = true;
+
+                WindowGeometry g;
+                if (windowGeometryWanted() && readGeometry(dpy, a, w, g)) windowGeometryUpdate(g);
+            }
+        }
+
+        changed |= next.size() != instances.size();
+
+        if (windowGeometryWanted())
+        {
+            for (const AppInstance& i : instances)
+            {
+                if (std::none_of(next.begin(), next.end(), [&i](const AppInstance& n) { return n.id == i.id; })) windowGeometryRemove(i.id);
+            }
+        }
+
+        instances = next;
+        return changed;
+    };
+
+    // only for clients, frames / override redirect windows aren't in the geometry index
+    auto updateGeometry = [&](Window w) {
+        if (!windowGeometryWanted()) return;
+
+        std::string id = windowId(w);
+        if (std::none_of(instances.begin(), instances.end(), [&id](const AppInstance& i) { return i.id == id; })) return;
+
+        WindowGeometry g;
+        if (readGeometry(dpy, a, w, g))
+            windowGeometryUpdate(g);
+        else
+            windowGeometryRemove(id);
+    };
+
+    auto refreshWindow = [&](Window w) {
+        std::string id = windowId(w);
+        for (AppInstance& i : instances)
+        {
+            if (i.id != id) continue;
+
+            AppInstance updated = readWindow(dpy, a, w);
+            bool changed = updated.title != i.title || updated.wclass != i.wclass || updated.fullscreen != i.fullscreen
+                || updated.pid != i.pid || updated.monitorIdx != i.monitorIdx;
+            i = updated;
+            return changed;
+        }
+        return false;
+    };
+
+    syncClientList();
+    onChange(instances);
+
+    int fd = ConnectionNumber(dpy);
+    bool geometrySynced = false;
+
+    while (running)
+    {
+        // intellihide may start wanting geometry after the watcher started (backends start before the window)
+        if (!geometrySynced && windowGeometryWanted())
+        {
+            for (const AppInstance& i : instances)
+                updateGeometry(parseWindowId(i.id));
+            geometrySynced = true;
+        }
+
+        if (XPending(dpy) == 0)
+        {
+            pollfd pfd = { fd, POLLIN, 0 };
+            int r = poll(&pfd, 1, 500);
+
+            if (r < 0 && errno != EINTR) break;
+            if (r <= 0) continue;   // timeout, recheck running
+        }
+
+        bool changed = false;
+
+        while (XPending(dpy) > 0)
+        {
+            XEvent ev;
+            XNextEvent(dpy, &ev);
+
+            if (ev.type == PropertyNotify)
+            {
+                Atom atom = ev.xproperty.atom;
+
+                if (ev.xproperty.window == root)
+                {
+                    if (atom == a.clientList) changed |= syncClientList();
+                } else if (atom == a.netWmName || atom == XA_WM_NAME || atom == XA_WM_CLASS || atom == a.netWmState || atom == a.netWmPid)
+                {
+                    changed |= refreshWindow(ev.xproperty.window);
+                    // minimized / restored
+                    if (atom == a.netWmState) updateGeometry(ev.xproperty.window);
+                }
+            } else if (ev.type == ConfigureNotify)
+            {
+                // moved, possibly to another monitor
+                changed |= refreshWindow(ev.xconfigure.window);
+                updateGeometry(ev.xconfigure.window);
+            } else if (ev.type == MapNotify || ev.type == UnmapNotify)
+            {
+                // desktop switches unmap / map the clients of the desktops involved
+                updateGeometry((ev.type == MapNotify) ? ev.xmap.window : ev.xunmap.window);
+            }
+        }
+
+        if (changed) onChange(instances);
+    }
+
+    closeDisplay(dpy);
+}
+
+static void sendRootMessage(Display * dpy, Window w, Atom type, long l0, long l1, long l2, long l3)
+{
+    XEvent ev = {};
+    ev.xclient.type = ClientMessage;
+    ev.xclient.window = w;
+    ev.xclient.message_type = type;
+    ev.xclient.format = 32;
+    ev.xclient.data.l[0] = l0;
+    ev.xclient.data.l[1] = l1;
+    ev.xclient.data.l[2] = l2;
+    ev.xclient.data.l[3] = l3;
+
+    XSendEvent(dpy, DefaultRootWindow(dpy), False, SubstructureRedirectMask | SubstructureNotifyMask, &ev);
+    XFlush(dpy);
+}
+
+void x11Activate(const std::string& id)
+{
+    Display * dpy = gdkXDisplay();
+    if (dpy == NULL) return;
+
+    // source indication 2 = pager, WMs honor those without focus stealing prevention
+    sendRootMessage(dpy, parseWindowId(id), XInternAtom(dpy, "_NET_ACTIVE_WINDOW", False), 2, CurrentTime, 0, 0);
+}
+
+void x11Close(const std::string& id)
+{
+    Display * dpy = gdkXDisplay();
+    if (dpy == NULL) return;
+
+    sendRootMessage(dpy, parseWindowId(id), XInternAtom(dpy, "_NET_CLOSE_WINDOW", False), CurrentTime, 2, 0, 0);
+}
+
+void x11ToggleMaximized(const std::string& id)
+{
+    Display * dpy = gdkXDisplay();
+    if (dpy == NULL) return;
+
+    X11Atoms a(dpy);
+    // action 2 = toggle
+    sendRootMessage(dpy, parseWindowId(id), a.netWmState, 2, a.netWmStateMaxVert, a.netWmStateMaxHorz, 2);
+}
+
+/*
+    dock placement: X11 has no layer shell, so the window is mapped as a dock and moved to the edge manually
+*/
+
+struct X11DockPlacement
+{
+    int dispIdx = 0;
+    int margin = 0;
+    DockEdge edge = DockEdge::EDGEBOTTOM;
+    DockAlignment alignment = DockAlignment::CENTER;
+    bool exclusive = false;
+};
+
+static std::map<Gtk::Window *, X11DockPlacement> placements = {};
+
+static void placeDockWindow(Gtk::Window * win)
+{
+    Display * dpy = gdkXDisplay();
+    if (dpy == NULL || !placements.contains(win) || win->get_surface() == nullptr) return;
+
+    const X11DockPlacement& p = placements[win];
+    Window xid = gdk_x11_surface_get_xid(win->get_surface()->gobj());
+
+    GdkRectangle g;
+    gdk_monitor_get_geometry(GDK_MONITOR(Gdk::Display::get_default()->get_monitors()->get_object(p.dispIdx)->gobj()), &g);
+
+    int w = win->get_width();
+    int h = win->get_height();
+    int x = g.x + (g.width - w) / 2;
+    int y = g.y + (g.height - h) / 2;
+
+    if (p.edge == DockEdge::EDGEBOTTOM || p.edge == DockEdge::EDGETOP)
+    {
+        y = (p.edge == DockEdge::EDGEBOTTOM) ? g.y + g.height - h - p.margin : g.y + p.margin;
+        if (p.alignment == DockAlignment::LEFT) x = g.x;
+        else if (p.alignment == DockAlignment::RIGHT) x = g.x + g.width - w;
+    } else
+    {
+        x = (p.edge == DockEdge::EDGERIGHT) ? g.x + g.width - w - p.margin : g.x + p.margin;
+        if (p.alignment == DockAlignment::TOP) y = g.y;
+        else if (p.alignment == DockAlignment::BOTTOM) y = g.y + g.height - h;
+    }
+
+    XMoveWindow(dpy, xid, x, y);
+
+    if (p.exclusive)
+    {
+        X11Atoms a(dpy);
+        // left right top bottom
+        long strut[4] = { 0, 0, 0, 0 };
+        if (p.edge == DockEdge::EDGELEFT) strut[0] = w + p.margin;
+        else if (p.edge == DockEdge::EDGERIGHT) strut[1] = w + p.margin;
+        else if (p.edge == DockEdge::EDGETOP) strut[2] = h + p.margin;
+        else strut[3] = h + p.margin;
+
+        XChangeProperty(dpy, xid, a.netWmStrut, XA_CARDINAL, 32, PropModeReplace, reinterpret_cast<unsigned char *>(strut), 4);
+    }
+
+    XFlush(dpy);
+}
+
+void x11SetupDockWindow(Gtk::Window * win, int dispIdx, int edgeMargin, DockEdge edge, DockAlignment alignment, bool exclusive)
+{
+    placements[win] = { dispIdx, edgeMargin, edge, alignment, exclusive };
+
+    // window type and state have to be set before the window gets mapped
+    win->signal_realize().connect([win]() {
+        Display * dpy = gdkXDisplay();
+        if (dpy == NULL) return;
+
+        X11Atoms a(dpy);
+        Window xid = gdk_x11_surface_get_xid(win->get_surface()->gobj());
+        long allDesktops = 0xFFFFFFFF;
+        Atom states[2] = { a.netWmStateAbove, a.netWmStateSticky };
+
+        XChangeProperty(dpy, xid, a.netWmWindowType, XA_ATOM, 32, PropModeReplace, reinterpret_cast<unsigned char *>(&a.netWmWindowTypeDock), 1);
+        XChangeProperty(dpy, xid, a.netWmState, XA_ATOM, 32, PropModeReplace, reinterpret_cast<unsigned char *>(states), 2);
+        XChangeProperty(dpy, xid, a.netWmDesktop, XA_CARDINAL, 32, PropModeReplace, reinterpret_cast<unsigned char *>(&allDesktops), 1);
+    });
+
+    win->signal_map().connect([win]() {
+        placeDockWindow(win);
+    });
+
+    // size changes (entries added / removed) move the anchor point
+    win->property_default_width().signal_changed().connect([win]() {
+        Glib::signal_idle().connect_once([win]() { placeDockWindow(win); });
+    });
+
+    win->property_default_height().signal_changed().connect([win]() {
+        Glib::signal_idle().connect_once([win]() { placeDockWindow(win); });
+    });
+}
+
+void x11SetDockMargin(Gtk::Window * win, int newMargin)
+{
+    if (!placements.contains(win)) return;
+
+    placements[win].margin = newMargin;
+    placeDockWindow(win);
+}
+
+/*
+    built in gtkdock_backend
+*/
+
+static std::atomic<bool> x11Watching(false);
+
+static int x11Probe()
+{
+    if (!x11EwmhAvailable()) return 0;
+
+    // probe runs on the main thread, the watcher thread can't ask gdk
+    x11CacheMonitorGeometry();
+    return 1;
+}
+
+static void x11Enumerate(gtkdock_instances_cb cb, void * user_data)
+{
+    emitInstances(x11GetWindows(), cb, user_data);
+}
+
+static int x11Subscribe(gtkdock_instances_cb cb, void * user_data)
+{
+    runWatcherThread(x11Watching, x11WatchInstances, x11GetWindows, cb, user_data);
+    return 0;
+}
+
+static void x11Unsubscribe()
+{
+    x11Watching = false;
+}
+
+static void x11ActivateId(const char * id)
+{
+    x11Activate(id);
+}
+
+static void x11CloseIds(const char * const * ids, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        x11Close(ids[i]);
+}
+
+static size_t x11MenuActions(const gtkdock_instance *, gtkdock_menu_action * actions, size_t max)
+{
+    if (max < 1) return 0;
+
+    actions[0] = { "Toggle Maximized", "maximize" };
+    return 1;
+}
+
+static void x11RunMenuAction(const char * id, const char * action)
+{
+    if (strcmp(action, "maximize") == 0) x11ToggleMaximized(id);
+}
+
+static const gtkdock_backend x11 = {
+    GTKDOCK_BACKEND_ABI_VERSION,
+    "x11-ewmh",
+    x11Probe,
+    x11Enumerate,
+    x11Subscribe,
+    x11Unsubscribe,
+    x11ActivateId,
+    x11CloseIds,
+    x11MenuActions,
+    x11RunMenuAction
+};
+
+const gtkdock_backend * x11Backend()
+{
+    return &x11;
+}
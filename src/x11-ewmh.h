@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <gtkmm-4.0/gtkmm.h>
+#include "utils.h"
+#include "dock-backend.h"
+
+/*
+    X11 / EWMH backend
+    tracks _NET_CLIENT_LIST, _NET_WM_NAME, WM_CLASS, _NET_WM_STATE and _NET_WM_PID through PropertyNotify
+    and talks to the window manager with client messages instead of spawning wmctrl / xdotool
+    also places the dock as a _NET_WM_WINDOW_TYPE_DOCK window since there is no layer shell on X11
+*/
+
+// true on a non wayland session whose window manager publishes _NET_CLIENT_LIST
+bool x11EwmhAvailable();
+
+// remembers monitor geometry (from gdk) so windows can be assigned to a monitor off the main thread
+void x11CacheMonitorGeometry();
+
+// reads _NET_CLIENT_LIST and converts every client to an AppInstance (id is the window id ex. 0x3a00007)
+std::vector<AppInstance> x11GetWindows();
+
+// blocks on its own X connection keeping an instance list that is updated from PropertyNotify / ConfigureNotify events
+// onChange gets called with the full list whenever it changed, returns once running is false
+// also keeps window-geometry.h up to date while it is wanted (Configure / Map / Unmap / _NET_WM_STATE_HIDDEN)
+void x11WatchInstances(std::atomic<bool>& running, const std::function<void(const std::vector<AppInstance>&)>& onChange);
+
+// _NET_ACTIVE_WINDOW / _NET_CLOSE_WINDOW / _NET_WM_STATE client messages (main thread only)
+void x11Activate(const std::string& id);
+void x11Close(const std::string& id);
+void x11ToggleMaximized(const std::string& id);
+
+// X11 replacement for the gtk-layer-shell setup: dock window type, stays on top of all desktops, anchored to edge
+void x11SetupDockWindow(Gtk::Window * win, int dispIdx, int edgeMargin, DockEdge edge, DockAlignment alignment, bool exclusive);
+void x11SetDockMargin(Gtk::Window * win, int newMargin);
+
+// the above as a gtkdock_backend (see backend.h)
+const gtkdock_backend * x11Backend();
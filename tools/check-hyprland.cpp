@@ -0,0 +1,86 @@
+/*
+    check-hyprland: runs the in-process hyprland backend (hyprlandWatchInstances) against fake-hyprland
+    and compares the window list it ends up with against an expected file, see make check-hyprland
+
+    usage: HYPRLAND_INSTANCE_SIGNATURE=<sig> ./build/check-hyprland <expected file>
+    expected: one window per line in list order, "address monitorIdx pid fullscreen(0/1) class title"
+    exits 0 once the backend reported that list, 1 if it didn't within TIMEOUT
+*/
+
+#include "hyprland-ipc.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+static const std::chrono::seconds TIMEOUT(10);
+
+static std::string describe(const std::vector<AppInstance>& instances)
+{
+    std::string text = "";
+
+    for (const AppInstance& i : instances)
+        text += i.id + " " + std::to_string(i.monitorIdx) + " " + std::to_string(i.pid) + " " + (i.fullscreen ? "1" : "0") + " " + i.wclass + " " + i.title + "\n";
+
+    return text;
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: HYPRLAND_INSTANCE_SIGNATURE=<sig> " << argv[0] << " <expected file>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(argv[1]);
+    std::string expected = "";
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        if (!line.empty()) expected += line + "\n";
+    }
+
+    // fake-hyprland gets started right before
+    auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (!hyprlandIpcAvailable() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::string last = "";
+    int updates = 0;
+
+    std::atomic<bool> running(true);
+
+    std::thread watcher([&]() {
+        hyprlandWatchInstances(running, [&](const std::vector<AppInstance>& instances) {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = describe(instances);
+            updates++;
+            cond.notify_one();
+        });
+    });
+
+    bool matched = false;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        matched = cond.wait_until(lock, deadline, [&]() { return last == expected; });
+    }
+
+    running = false;
+    watcher.join();
+
+    if (matched)
+    {
+        std::cout << "check-hyprland: ok (" << updates << " updates)" << std::endl;
+        return 0;
+    }
+
+    std::cout << "check-hyprland: FAILED after " << updates << " updates\nexpected:\n" << expected << "got:\n" << last;
+    return 1;
+}
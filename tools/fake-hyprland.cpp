@@ -0,0 +1,259 @@
+/*
+    fake-hyprland: stand in for hyprland's ipc sockets to drive the in-process hyprland backend (hyprland-ipc.cpp) without hyprland
+
+    usage: HYPRLAND_INSTANCE_SIGNATURE=fake ./build/fake-hyprland <reply dir>
+    then start GTKDock with the same HYPRLAND_INSTANCE_SIGNATURE / XDG_RUNTIME_DIR
+
+    .socket.sock: "j/clients" gets <reply dir>/clients.json as reply ("j/activewindow" -> activewindow.json ...),
+                  dispatches / [[BATCH]] get "ok", anything without a reply file "unknown request"
+    .socket2.sock: every line typed on stdin ex. "openwindow>>80e62df0,1,kitty,~" is sent to all connected listeners,
+                   edit the reply files before sending the event so the backend's follow up requests see the change
+
+    --script <file>: the events come from file instead (make check-hyprland), one per line, each followed by 100ms
+                     of answering requests, besides events the file can have
+                         listen                 wait until the backend connected to .socket2.sock (and give it 100ms to sync)
+                         sleep <ms>             keep answering requests for a while
+                         reply <name> <file>    answer "j/<name>" from <reply dir>/<file>.json from now on
+                         # ...                  comments
+                     afterwards it keeps answering requests until it gets killed
+*/
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <poll.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <chrono>
+
+static int listenOn(const std::string& path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    unlink(path.c_str());
+    if (bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 16) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static void writeAll(int fd, const std::string& data)
+{
+    size_t written = 0;
+
+    while (written < data.size())
+    {
+        ssize_t n = send(fd, data.c_str() + written, data.size() - written, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        written += n;
+    }
+}
+
+// reply files the script switched to, request name -> file name
+static std::map<std::string, std::string> replyFiles = {};
+
+// "j/clients" -> <dir>/clients.json
+static std::string reply(const std::string& dir, const std::string& request)
+{
+    if (request.rfind("[[BATCH]]", 0) == 0 || request.rfind("dispatch ", 0) == 0) return "ok";
+
+    std::string name = (request.rfind("j/", 0) == 0) ? request.substr(2) : request;
+    std::replace(name.begin(), name.end(), '/', '_');
+
+    auto file = replyFiles.find(name);
+    if (file != replyFiles.end()) name = file->second;
+
+    std::ifstream in(dir + "/" + name + ".json");
+    if (!in) return "unknown request";
+
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// one request per connection like hyprland: read it, answer, close
+static void serveRequest(int listenFd, const std::string& dir)
+{
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) return;
+
+    char buffer[8192];
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+
+    if (n > 0)
+    {
+        std::string request(buffer, n);
+        std::cout << "request: " << request << std::endl;
+        writeAll(fd, reply(dir, request));
+    }
+
+    close(fd);
+}
+
+// sends one event line to every listener, listeners that went away get dropped on the first failed write
+static void broadcast(std::vector<int>& listeners, const std::string& line)
+{
+    listeners.erase(std::remove_if(listeners.begin(), listeners.end(), [&line](int fd) {
+        if (send(fd, line.c_str(), line.size(), MSG_NOSIGNAL) == (ssize_t)line.size()) return false;
+        close(fd);
+        return true;
+    }), listeners.end());
+}
+
+// answers requests / accepts listeners until ms passed (-1: until stdin has something, returns false once it closed)
+static bool serve(int requests, int events, std::vector<int>& listeners, const std::string& dir, int ms, bool withStdin)
+{
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+
+    while (true)
+    {
+        int left = -1;
+        if (ms >= 0)
+        {
+            left = std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now()).count();
+            if (left <= 0) return true;
+        }
+
+        std::vector<pollfd> fds = { { requests, POLLIN, 0 }, { events, POLLIN, 0 } };
+        if (withStdin) fds.push_back({ STDIN_FILENO, POLLIN, 0 });
+
+        if (poll(fds.data(), fds.size(), left) < 0)
+        {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        if (fds[0].revents & POLLIN) serveRequest(requests, dir);
+
+        if (fds[1].revents & POLLIN)
+        {
+            int fd = accept(events, nullptr, nullptr);
+            if (fd >= 0) listeners.push_back(fd);
+        }
+
+        if (withStdin && (fds[2].revents & (POLLIN | POLLHUP))) return true;
+    }
+}
+
+static void runScript(const std::string& path, int requests, int events, std::vector<int>& listeners, const std::string& dir)
+{
+    std::ifstream script(path);
+    std::string line;
+
+    while (std::getline(script, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::stringstream words(line);
+        std::string cmd;
+        words >> cmd;
+
+        if (cmd == "listen")
+        {
+            while (listeners.empty())
+                serve(requests, events, listeners, dir, 50, false);
+            serve(requests, events, listeners, dir, 100, false);
+        } else if (cmd == "sleep")
+        {
+            int ms = 0;
+            words >> ms;
+            serve(requests, events, listeners, dir, ms, false);
+        } else if (cmd == "reply")
+        {
+            std::string name, file;
+            words >> name >> file;
+            replyFiles[name] = file;
+        } else
+        {
+            std::cout << "event: " << line << std::endl;
+            broadcast(listeners, line + "\n");
+            serve(requests, events, listeners, dir, 100, false);
+        }
+    }
+
+    while (true)
+        serve(requests, events, listeners, dir, 1000, false);
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: HYPRLAND_INSTANCE_SIGNATURE=<sig> " << argv[0] << " <reply dir> [--script <file>]" << std::endl;
+        return 1;
+    }
+
+    const char * sig = std::getenv("HYPRLAND_INSTANCE_SIGNATURE");
+    const char * runtime = std::getenv("XDG_RUNTIME_DIR");
+
+    if (sig == NULL || runtime == NULL)
+    {
+        std::cerr << "HYPRLAND_INSTANCE_SIGNATURE and XDG_RUNTIME_DIR have to be set" << std::endl;
+        return 1;
+    }
+
+    std::string dir = std::string(runtime) + "/hypr";
+    mkdir(dir.c_str(), 0700);
+    dir += std::string("/") + sig;
+    mkdir(dir.c_str(), 0700);
+
+    int requests = listenOn(dir + "/.socket.sock");
+    int events = listenOn(dir + "/.socket2.sock");
+
+    if (requests < 0 || events < 0)
+    {
+        std::cerr << "can't listen in " << dir << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    std::vector<int> listeners = {};
+
+    if (argc >= 4 && std::string(argv[2]) == "--script")
+    {
+        std::cout << "serving " << dir << ", events from " << argv[3] << std::endl;
+        runScript(argv[3], requests, events, listeners, argv[1]);
+        return 0;
+    }
+
+    std::cout << "serving " << dir << ", type events (EVENT>>DATA) to send them" << std::endl;
+
+    std::string input;
+
+    while (serve(requests, events, listeners, argv[1], -1, true))
+    {
+        char buffer[4096];
+        ssize_t n = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (n <= 0) break;
+
+        input.append(buffer, n);
+        size_t nl;
+
+        while ((nl = input.find('\n')) != std::string::npos)
+        {
+            broadcast(listeners, input.substr(0, nl + 1));
+            input.erase(0, nl + 1);
+        }
+    }
+
+    unlink((dir + "/.socket.sock").c_str());
+    unlink((dir + "/.socket2.sock").c_str());
+    return 0;
+}